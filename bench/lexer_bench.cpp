@@ -0,0 +1,177 @@
+// Identifier-heavy lexing throughput. Not part of ctest; run build/bin/lexer_bench [bytes | file].
+//
+// "map" is the keyword lookup the lexer used before include/lexer/keywords.hpp: a hashed
+// std::unordered_map probed once per identifier. "perfect" is lexer::keyword_type.
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "lexer/keywords.hpp"
+#include "lexer/lexer.hpp"
+#include "lexer/scan.hpp"
+#include "support/source_buffer.hpp"
+
+namespace {
+
+auto make_source(std::size_t bytes) -> std::string {
+    static constexpr std::string_view words[] = {
+        "int",   "counter", "x",      "return", "value_2", "if",    "index",
+        "float", "else",    "buffer", "for",    "tmp",     "double", "result_accumulator",
+        "void",  "i",       "retval", "n",      "iffy",    "format",
+    };
+    std::string out;
+    out.reserve(bytes + 32);
+    std::size_t i = 0;
+    while (out.size() < bytes) {
+        out += words[(i * 7 + i / 3) % std::size(words)];
+        out += (++i % 12 == 0) ? ";\n" : " ";
+    }
+    return out;
+}
+
+// `source` with an indented, commented line after every line: long blank and comment runs
+auto with_comments(std::string_view source) -> std::string {
+    std::string out;
+    for (const char c : source) {
+        out += c;
+        if (c == '\n') {
+            out += "        // the vector paths pay off on long runs like this comment\n";
+        }
+    }
+    return out;
+}
+
+auto identifier_spans(std::string_view source) -> std::vector<std::string_view> {
+    std::vector<std::string_view> spans;
+    std::size_t i = 0;
+    while (i < source.size()) {
+        const auto begin = i;
+        while (i < source.size() && (std::isalnum(static_cast<unsigned char>(source[i])) != 0 ||
+                                     source[i] == '_')) {
+            i++;
+        }
+        if (i > begin) {
+            spans.push_back(source.substr(begin, i - begin));
+        } else {
+            i++;
+        }
+    }
+    return spans;
+}
+
+// The lexer's scanning without building tokens: how fast `scanner` gets through the source.
+// Returns the number of runs so the work cannot be optimised away.
+auto skim(const lexer::Scanner& scanner, std::string_view source) -> std::size_t {
+    const char* p = source.data();
+    const char* end = p + source.size();
+    std::size_t runs = 0;
+    while (p != end) {
+        const char c = *p;
+        if (c == ' ' || c == '\t' || c == '\r') {
+            p = scanner.skip_blanks(p, end);
+        } else if ((c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z')) {
+            p = scanner.identifier_end(p, end);
+        } else if (c == '/' && p + 1 != end && p[1] == '/') {
+            p = scanner.find_newline(p, end);
+        } else {
+            p++;
+            continue;
+        }
+        runs++;
+    }
+    return runs;
+}
+
+template <typename Fn>
+auto best_of(int runs, Fn&& fn) -> double {
+    double best = 1e300;
+    for (int run = 0; run < runs; run++) {
+        const auto begin = std::chrono::steady_clock::now();
+        fn();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+}  // namespace
+
+auto main(int argc, char** argv) -> int {
+    std::size_t bytes = 16u << 20;
+    std::string source;
+    if (argc > 1) {
+        char* rest = nullptr;
+        bytes = std::strtoull(argv[1], &rest, 10);
+        if (*rest != '\0') {
+            source = std::string(support::SourceBuffer::open(argv[1]).view());
+        }
+    }
+    if (source.empty()) {
+        source = make_source(bytes);
+    }
+    const auto spans = identifier_spans(source);
+    constexpr int runs = 10;
+
+    std::unordered_map<std::string_view, TokType> map;
+    for (const auto& keyword : lexer::keyword_list) {
+        map.emplace(keyword.text, keyword.type);
+    }
+
+    // the sums keep the lookups from being optimised away
+    std::size_t map_keywords = 0;
+    const auto map_seconds = best_of(runs, [&] {
+        map_keywords = 0;
+        for (const auto span : spans) {
+            const auto it = map.find(span);
+            map_keywords += it != map.end() ? 1 : 0;
+        }
+    });
+    std::size_t perfect_keywords = 0;
+    const auto perfect_seconds = best_of(runs, [&] {
+        perfect_keywords = 0;
+        for (const auto span : spans) {
+            perfect_keywords += lexer::keyword_type(span) != TokType::TOKEN_IDENTIFIER;
+        }
+    });
+    std::size_t tokens = 0;
+    const auto lex_seconds = best_of(runs, [&] { tokens = lexer::lex(source).size(); });
+    const auto commented = with_comments(source);
+    std::size_t commented_tokens = 0;
+    const auto commented_lex_seconds =
+        best_of(runs, [&] { commented_tokens = lexer::lex(commented).size(); });
+
+    if (map_keywords != perfect_keywords) {
+        std::fprintf(stderr, "keyword counts differ: %zu vs %zu\n", map_keywords,
+                     perfect_keywords);
+        return 1;
+    }
+    if (tokens != commented_tokens) {
+        std::fprintf(stderr, "comments changed the token count: %zu vs %zu\n", tokens,
+                     commented_tokens);
+        return 1;
+    }
+    for (const auto& scanner : lexer::available_scanners()) {
+        std::size_t found = 0;
+        const auto seconds = best_of(runs, [&] { found += skim(scanner, source); });
+        const auto commented_seconds = best_of(runs, [&] { found += skim(scanner, commented); });
+        std::printf("scan %-7s %8.1f MB/s, with comments %8.1f MB/s (%zu runs)\n",
+                    scanner.name.data(), source.size() / seconds / 1e6,
+                    commented.size() / commented_seconds / 1e6, found);
+    }
+
+    const auto per_ns = [&](double seconds) { return seconds * 1e9 / spans.size(); };
+    std::printf("%zu bytes, %zu identifiers (%zu keywords), %zu tokens\n", source.size(),
+                spans.size(), perfect_keywords, tokens);
+    std::printf("keyword lookup  map      %6.2f ns/identifier\n", per_ns(map_seconds));
+    std::printf("keyword lookup  perfect  %6.2f ns/identifier\n", per_ns(perfect_seconds));
+    std::printf("lex                      %6.1f MB/s, with comments %6.1f MB/s\n",
+                source.size() / lex_seconds / 1e6, commented.size() / commented_lex_seconds / 1e6);
+    return 0;
+}
@@ -0,0 +1,128 @@
+// Parser throughput and heap use. Not part of ctest; run build/bin/parser_bench [count].
+//
+// Counts every operator new, first while walking the tokens the way the parser inspects them
+// (peek, the syntax_utils predicates, advance), then while parsing already lexed tokens. The
+// walk should allocate nothing; the parse allocates only what the syntax tree keeps. Also
+// reports the peak heap in use while parsing and how long freeing the syntax tree takes. The
+// default of 9100 functions is about 100k lines.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "lexer/lexer.hpp"
+#include "parser/parser.hpp"
+#include "parser/syntax_utils.hpp"
+#include "parser/token_stream.hpp"
+
+namespace {
+
+std::atomic<std::size_t> allocations = 0;
+std::atomic<std::size_t> live_bytes = 0;
+std::atomic<std::size_t> peak_bytes = 0;
+
+auto make_source(std::size_t functions) -> std::string {
+    std::string out;
+    for (std::size_t i = 0; i < functions; i++) {
+        const auto n = std::to_string(i);
+        out += "int f" + n + "(int a, int b) {\n";
+        out += "    int x = a + b * 2;\n";
+        out += "    float y = 1.5;\n";
+        out += "    for (int i = 0; i < 10; i = i + 1) {\n";
+        out += "        x = x + i - b;\n";
+        out += "    }\n";
+        out += "    if (x > " + n + ") {\n";
+        out += "        return x;\n";
+        out += "    }\n";
+        out += "    return a - b;\n";
+        out += "}\n";
+    }
+    return out + "int main() {\n    return f0(1, 2);\n}\n";
+}
+
+}  // namespace
+
+auto operator new(std::size_t size) -> void* {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        const auto live =
+            live_bytes.fetch_add(malloc_usable_size(p), std::memory_order_relaxed) +
+            malloc_usable_size(p);
+        auto peak = peak_bytes.load(std::memory_order_relaxed);
+        while (live > peak && !peak_bytes.compare_exchange_weak(peak, live)) {
+        }
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    live_bytes.fetch_sub(malloc_usable_size(p), std::memory_order_relaxed);
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t /*size*/) noexcept { operator delete(p); }
+
+auto main(int argc, char** argv) -> int {
+    const std::size_t functions = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 9100;
+    const auto source = make_source(functions);
+    const auto tokens = lexer::lex(source);
+
+    constexpr int runs = 10;
+
+    std::size_t matches = 0;
+    auto before = allocations.load();
+    TokenStream stream(tokens);
+    while (stream.peek().type != TokType::TOKEN_FEOF) {
+        matches += isStmtBegin(stream.peek()) ? 1 : 0;
+        matches += isTypeSpecifier(stream.peek()) ? 1 : 0;
+        matches += isFuncBegin(stream.peek(), stream.peek(1), stream.peek(2)) ? 1 : 0;
+        static_cast<void>(stream.advance());
+    }
+    const auto walk_allocations = allocations.load() - before;
+
+    double best = 1e300;
+    double best_free = 1e300;
+    std::size_t nodes = 0;
+    std::size_t parse_allocations = 0;
+    std::size_t parse_peak = 0;
+    for (int run = 0; run < runs; run++) {
+        before = allocations.load();
+        const auto live_before = live_bytes.load();
+        peak_bytes = live_before;
+        const auto begin = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point freeing;
+        {
+            const auto program = parse(tokens, source);
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+            best = std::min(best, elapsed.count());
+            parse_allocations = allocations.load() - before;
+            parse_peak = peak_bytes.load() - live_before;
+            nodes = st::count_nodes(program);
+            freeing = std::chrono::steady_clock::now();
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - freeing;
+        best_free = std::min(best_free, elapsed.count());
+    }
+
+    std::printf("%zu bytes, %zu tokens, %zu syntax tree nodes\n", source.size(), tokens.size(),
+                nodes);
+    std::printf("parse          %8.2f ms, %6.1f ns/token\n", best * 1e3,
+                best * 1e9 / tokens.size());
+    std::printf("token walk     %8zu allocations, %5.2f per token (%zu matches)\n",
+                walk_allocations, static_cast<double>(walk_allocations) / tokens.size(), matches);
+    std::printf("parse          %8zu allocations, %5.2f per token, %5.2f per node\n",
+                parse_allocations, static_cast<double>(parse_allocations) / tokens.size(),
+                static_cast<double>(parse_allocations) / nodes);
+    std::printf("parse peak     %8.2f MiB, %5.1f bytes per node\n",
+                static_cast<double>(parse_peak) / (1 << 20),
+                static_cast<double>(parse_peak) / nodes);
+    std::printf("free tree      %8.2f ms\n", best_free * 1e3);
+    return 0;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <ostream>
 #include <string>
 
 namespace ast {
@@ -10,7 +11,12 @@ class AstNode {
    public:
     virtual ~AstNode() = default;
     [[nodiscard]] virtual std::string toString() const = 0;
+    // Composite nodes override print() so a whole tree can be streamed without first being
+    // built up as one string; leaves fall back to toString().
+    virtual std::ostream& print(std::ostream& os) const { return os << toString(); }
     virtual const ast::BinOpKind* get_bin_op() const { return nullptr; }
 };
 
-}  // namespace ast
\ No newline at end of file
+[[nodiscard]] auto print_to_string(const AstNode& node) -> std::string;
+
+}  // namespace ast
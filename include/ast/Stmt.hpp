@@ -44,6 +44,7 @@ struct Stmt : public AstNode {
     [[nodiscard]] auto get_binary_op_node() -> std::shared_ptr<BinaryOpAstNode>;
 
     [[nodiscard]] std::string toString() const override;
+    std::ostream& print(std::ostream& os) const override;
 };
 
 struct BodyNode : public AstNode {
@@ -58,6 +59,7 @@ struct BodyNode : public AstNode {
     [[nodiscard]] auto get_move() -> std::shared_ptr<MoveAstNode>;
 
     [[nodiscard]] auto toString() const -> std::string override;
+    auto print(std::ostream& os) const -> std::ostream& override;
 };
 
 struct ExprNode : public AstNode {
@@ -72,6 +74,7 @@ struct ExprNode : public AstNode {
     ExprNode(std::shared_ptr<T> p_node) : node(p_node) {}
 
     [[nodiscard]] std::string toString() const override;
+    std::ostream& print(std::ostream& os) const override;
     [[nodiscard]] const std::string get_variable_name() const;
     [[nodiscard]] auto is_variable_ast_node() const -> bool;
     [[nodiscard]] ast::DataType get_variable_type() const;
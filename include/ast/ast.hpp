@@ -47,8 +47,11 @@ struct ReturnAstNode : public AstNode {
 
     explicit ReturnAstNode(ExprNode p_expr) : expr(std::move(p_expr)) {}
 
-    [[nodiscard]] auto toString() const -> std::string override {
-        return "return " + expr.toString();
+    [[nodiscard]] auto toString() const -> std::string override { return print_to_string(*this); }
+
+    auto print(std::ostream& os) const -> std::ostream& override {
+        os << "return ";
+        return expr.print(os);
     }
 };
 
@@ -62,17 +65,18 @@ struct FrameAstNode : public AstNode {
                  std::vector<FrameParam> p_params)
         : name(p_name), body(std::move(p_body)), params(std::move(p_params)) {}
 
-    [[nodiscard]] auto toString() const -> std::string override {
-        auto result = "fn " + name + "(";
+    [[nodiscard]] auto toString() const -> std::string override { return print_to_string(*this); }
+
+    auto print(std::ostream& os) const -> std::ostream& override {
+        os << "fn " << name << "(";
         for (const auto& param : params) {
-            result += param.name + ", ";
+            os << param.name << ", ";
         }
-        result += ") {\n";
+        os << ") {\n";
         for (const auto& node : body) {
-            result += node.toString() + "\n";
+            node.print(os) << "\n";
         }
-        result += "}";
-        return result;
+        return os << "}";
     }
 };
 
@@ -86,6 +90,7 @@ struct MoveAstNode : public AstNode {
         : lhs(std::move(p_lhs)), rhs(std::move(p_rhs)) {}
 
     [[nodiscard]] auto toString() const -> std::string override;
+    auto print(std::ostream& os) const -> std::ostream& override;
 };
 
 struct BinaryOpAstNode : public AstNode {
@@ -99,8 +104,11 @@ struct BinaryOpAstNode : public AstNode {
 
     const BinOpKind* get_bin_op() const override { return &kind; }
 
-    [[nodiscard]] auto toString() const -> std::string override {
-        return lhs.toString() + " " + bin_op_to_string(kind) + " " + rhs.toString();
+    [[nodiscard]] auto toString() const -> std::string override { return print_to_string(*this); }
+
+    auto print(std::ostream& os) const -> std::ostream& override {
+        lhs.print(os) << " " << bin_op_to_string(kind) << " ";
+        return rhs.print(os);
     }
 };
 
@@ -117,7 +125,12 @@ struct DerefReadAstNode : public AstNode {
         return 1;
     }
 
-    [[nodiscard]] auto toString() const -> std::string override { return "*" + expr.toString(); }
+    [[nodiscard]] auto toString() const -> std::string override { return print_to_string(*this); }
+
+    auto print(std::ostream& os) const -> std::ostream& override {
+        os << "*";
+        return expr.print(os);
+    }
 };
 
 struct DerefWriteAstNode : public AstNode {
@@ -126,7 +139,12 @@ struct DerefWriteAstNode : public AstNode {
 
     explicit DerefWriteAstNode(ExprNode p_expr) : expr(std::move(p_expr)) {}
 
-    [[nodiscard]] auto toString() const -> std::string override { return "*" + expr.toString(); }
+    [[nodiscard]] auto toString() const -> std::string override { return print_to_string(*this); }
+
+    auto print(std::ostream& os) const -> std::ostream& override {
+        os << "*";
+        return expr.print(os);
+    }
 };
 
 struct AddrAstNode : public AstNode {
@@ -135,7 +153,12 @@ struct AddrAstNode : public AstNode {
 
     explicit AddrAstNode(ExprNode p_expr) : expr(std::move(p_expr)) {}
 
-    [[nodiscard]] auto toString() const -> std::string override { return "&" + expr.toString(); }
+    [[nodiscard]] auto toString() const -> std::string override { return print_to_string(*this); }
+
+    auto print(std::ostream& os) const -> std::ostream& override {
+        os << "&";
+        return expr.print(os);
+    }
 };
 
 struct JumpAstNode : public AstNode {
@@ -176,20 +199,23 @@ struct IfNode : public AstNode {
            std::optional<std::vector<BodyNode>> p_else)
         : condition(std::move(p_condition)), then(std::move(p_then)), else_(std::move(p_else)) {}
 
-    [[nodiscard]] auto toString() const -> std::string override {
-        std::string result = "if (" + condition->toString() + ") {\n";
+    [[nodiscard]] auto toString() const -> std::string override { return print_to_string(*this); }
+
+    auto print(std::ostream& os) const -> std::ostream& override {
+        os << "if (";
+        condition->print(os) << ") {\n";
         for (const auto& node : then) {
-            result += node.toString() + "\n";
+            node.print(os) << "\n";
         }
-        result += "}\n";
+        os << "}\n";
         if (else_.has_value()) {
-            result += "else {\n";
+            os << "else {\n";
             for (const auto& node : else_.value()) {
-                result += node.toString() + "\n";
+                node.print(os) << "\n";
             }
-            result += "}";
+            os << "}";
         }
-        return result;
+        return os;
     }
 };
 
@@ -223,25 +249,26 @@ struct ForLoopAstNode : public AstNode {
           forUpdate(std::move(p_for_update)),
           forBody(std::move(p_for_body)) {}
 
-    [[nodiscard]] auto toString() const -> std::string override {
-        std::string result = "for (";
+    [[nodiscard]] auto toString() const -> std::string override { return print_to_string(*this); }
+
+    auto print(std::ostream& os) const -> std::ostream& override {
+        os << "for (";
         if (forInit) {
-            result += forInit->toString();
+            forInit->print(os);
         }
-        result += "; ";
+        os << "; ";
         if (forCondition.has_value()) {
-            result += forCondition.value()->toString();
+            forCondition.value()->print(os);
         }
-        result += "; ";
+        os << "; ";
         if (forUpdate.has_value()) {
-            result += forUpdate.value().toString();
+            forUpdate.value().print(os);
         }
-        result += ") {\n";
+        os << ") {\n";
         for (const auto& node : forBody) {
-            result += node.toString() + "\n";
+            node.print(os) << "\n";
         }
-        result += "}";
-        return result;
+        return os << "}";
     }
 };
 
@@ -267,6 +294,19 @@ struct TopLevelNode : public AstNode {
     [[nodiscard]] auto toString() const -> std::string override {
         return std::visit([](const auto& v_node) { return v_node->toString(); }, node);
     }
+
+    auto print(std::ostream& os) const -> std::ostream& override {
+        return std::visit([&os](const auto& v_node) -> std::ostream& { return v_node->print(os); },
+                          node);
+    }
 };
 
+// number of AST nodes reachable from the top level nodes, for the time report
+[[nodiscard]] auto count_nodes(const std::vector<TopLevelNode>& nodes) -> std::size_t;
+
+// Exact serialisation of everything the back end reads from a function, used to key the per
+// function cache. Unlike print() nothing is elided: call arguments, types and float bits are
+// all included.
+[[nodiscard]] auto fingerprint(const FrameAstNode& frame) -> std::string;
+
 }  // namespace ast
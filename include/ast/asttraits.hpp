@@ -4,6 +4,7 @@
 #include <cstddef>
 #include <functional>
 #include <memory>
+#include <span>
 #include <string>
 
 #include "../parser/st.hpp"
@@ -13,12 +14,12 @@ namespace ast {
 
 template <typename T>
 concept ContainsTypeDeclaration = requires(T t) {
-    { t.declarationSpecifiers } -> std::convertible_to<std::vector<st::DeclarationSpecifier>>;
+    { t.declarationSpecifiers } -> std::convertible_to<st::NodeList<st::DeclarationSpecifier>>;
     { t.GetDeclarator() } -> std::convertible_to<std::optional<st::Declarator>>;
 };
 
 // TODO: use the dss parameter here
-[[nodiscard]] DataType toDataType(const std::vector<st::DeclarationSpecifier>& dss) {
+[[nodiscard]] DataType toDataType(std::span<const st::DeclarationSpecifier> dss) {
     for (const auto& ds : dss) {
         if (ds.typespecifier.type == st::TypeSpecifier::Type::INT) {
             return DataType::int_type();
@@ -29,23 +30,27 @@ concept ContainsTypeDeclaration = requires(T t) {
     throw std::runtime_error("Unsupported type specifier");
 }
 
-[[nodiscard]] DataType toDataType(const st::Declarator& decl, DataType pointsTo) {
+[[nodiscard]] DataType toDataType(const st::Tree& tree, const st::Declarator& decl,
+                                  DataType pointsTo) {
     const auto directDeclarator = decl.directDeclarator;
     if (directDeclarator.kind == st::DeclaratorKind::VARIABLE) {
         return DataType{
             .base_type = BaseType::POINTER, .points_to = pointsTo.base_type, .indirect_level = 1};
     } else if (directDeclarator.kind == st::DeclaratorKind::ARRAY) {
         const auto info = std::get<st::ArrayDirectDeclarator>(directDeclarator.declarator);
-        const auto expression = std::get<std::shared_ptr<st::PrimaryExpression>>(info.size);
-        return DataType::array_type(expression->value, pointsTo.base_type);
+        if (info.size.kind != st::ExpressionKind::PRIMARY) {
+            throw std::runtime_error("Array size must be a constant");
+        }
+        const auto& expression = tree.get<st::PrimaryExpression>(info.size);
+        return DataType::array_type(expression.value, pointsTo.base_type);
     } else {
         throw std::runtime_error("Unsupported declarator kind");
     }
 }
 
 template <ContainsTypeDeclaration T>
-DataType toDataType(const T& decl) {
-    auto datatype = toDataType(decl.declarationSpecifiers);
+DataType toDataType(const st::Tree& tree, const T& decl) {
+    auto datatype = toDataType(tree.list(decl.declarationSpecifiers));
     std::optional<st::Declarator> opt_declarator = decl.GetDeclarator();
     if (!opt_declarator) {
         return datatype;
@@ -53,7 +58,7 @@ DataType toDataType(const T& decl) {
     auto declarator = opt_declarator.value();
 
     if (declarator.pointer || declarator.directDeclarator.kind == st::DeclaratorKind::ARRAY) {
-        datatype = toDataType(declarator, datatype);
+        datatype = toDataType(tree, declarator, datatype);
     }
     return datatype;
 }
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// On-disk cache of generated assembly, for whole translation units and for single functions.
+// Every entry is a file named after the SHA-256 of its input and of the compiler build that
+// produced it. Entries are published with rename(2), so
+// qac processes sharing a directory never observe a partially written entry, and a file's
+// mtime records when it was last used for least recently used eviction.
+class CompileCache {
+   public:
+    CompileCache(std::filesystem::path p_directory, std::uintmax_t p_max_bytes);
+
+    // `kind` keeps keys of different entry formats apart, e.g. "unit" for a whole source file
+    [[nodiscard]] auto key(std::string_view kind, std::string_view contents) const -> std::string;
+    // Copies the entry to `outfile`. Returns false on a miss, including an entry that another
+    // process evicted while it was being copied.
+    [[nodiscard]] auto fetch(const std::string& key, const std::string& outfile) const -> bool;
+    [[nodiscard]] auto load(const std::string& key) const -> std::optional<std::string>;
+    // Returns false when the entry could not be written, e.g. the directory is not usable. The
+    // cache is best effort, so that only costs the next compile a miss.
+    [[nodiscard]] auto store(const std::string& key, std::string_view contents) const -> bool;
+    // Removes least recently used entries until the cache fits its size, and temporaries that
+    // stores of crashed processes left behind. Scans the directory, so call it once after a batch
+    // of stores.
+    void evict() const;
+
+   private:
+    [[nodiscard]] auto entry_path(const std::string& key) const -> std::filesystem::path;
+
+    std::filesystem::path directory;
+    std::uintmax_t max_bytes;
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../ast/ast.hpp"
+#include "../parser/operators.hpp"
+#include "../parser/parser.hpp"
+#include "../parser/st.hpp"
+#include "translate.hpp"
+
+namespace ast {
+
+// Valid input the single pass front end does not translate the way translate() does.
+class NotReproducible : public std::runtime_error {
+   public:
+    using std::runtime_error::runtime_error;
+};
+
+// Builder for the single pass front end: turns each construct into the nodes translate() would
+// make of it as soon as the parser has it, so no syntax tree is kept. Only declarators are still
+// st:: values, in a tree that holds nothing else.
+//
+// translate() knows an expression is the target of an assignment before translating it, here
+// the `=` only shows up afterwards and the dereferences in the target become writes then. Input
+// this cannot reproduce exactly, such as an assignment inside a target, throws NotReproducible;
+// the two pass front end handles it.
+class AstBuilder {
+   public:
+    struct Expression {
+        ExprNode node;
+        // the number or name the expression consists of, possibly in parentheses
+        std::optional<st::PrimaryExpression> primary = std::nullopt;
+        bool contains_assignment = false;
+    };
+    using Statement = Stmt;
+    using BlockItem = BodyNode;
+    using CompoundStatement = std::vector<BodyNode>;
+    using Declaration = std::shared_ptr<MoveAstNode>;
+    using ExternalDeclaration = TopLevelNode;
+    using Program = std::vector<TopLevelNode>;
+
+    struct Function {
+        std::string name;
+        std::vector<FrameParam> params;
+    };
+
+    AstBuilder();
+    // ctx refers to declarations
+    AstBuilder(const AstBuilder&) = delete;
+    auto operator=(const AstBuilder&) -> AstBuilder& = delete;
+
+    [[nodiscard]] auto syntax_tree() -> st::Tree& { return declarations; }
+
+    [[nodiscard]] auto primary(st::PrimaryExpression expr) -> Expression;
+    [[nodiscard]] auto callee_name(const Expression& callee) const -> std::string_view;
+    [[nodiscard]] auto call(std::string_view name, std::span<Expression> args) -> Expression;
+    [[nodiscard]] auto array_access(std::string_view name, Expression index) -> Expression;
+    [[nodiscard]] auto unary(st::UnaryExpressionType type, Expression operand) -> Expression;
+    auto begin_right_operand(BinaryOp op, Expression& lhs) -> void;
+    [[nodiscard]] auto binary(BinaryOp op, Expression lhs, Expression rhs) -> Expression;
+    [[nodiscard]] auto array_size(const Expression& size) -> st::Expression;
+
+    auto begin_return() -> void;
+    [[nodiscard]] auto return_statement(Expression expr) -> Statement;
+    [[nodiscard]] auto expression_statement(const Expression& expr) -> Statement;
+    [[nodiscard]] auto if_statement(Expression cond, CompoundStatement then,
+                                    std::optional<CompoundStatement> else_) -> Statement;
+    [[nodiscard]] auto for_statement(Declaration init, std::optional<Expression> cond,
+                                     std::optional<Expression> inc, CompoundStatement body)
+        -> Statement;
+    [[nodiscard]] auto block(std::span<BlockItem> items) -> CompoundStatement;
+
+    [[nodiscard]] auto declare(st::NodeList<st::DeclarationSpecifier> specifiers,
+                               const st::Declarator& declarator)
+        -> std::shared_ptr<VariableAstNode>;
+    auto begin_initializer() -> void;
+    [[nodiscard]] auto declaration(std::shared_ptr<VariableAstNode> declared,
+                                   std::optional<Expression> initializer) -> Declaration;
+
+    [[nodiscard]] auto begin_function(st::NodeList<st::DeclarationSpecifier> specifiers,
+                                      const st::Declarator& declarator) -> Function;
+    [[nodiscard]] auto function(Function fn, CompoundStatement body) -> ExternalDeclaration;
+    [[nodiscard]] auto external(Declaration decl) -> ExternalDeclaration;
+    [[nodiscard]] auto program(std::vector<ExternalDeclaration> nodes) -> Program;
+
+   private:
+    st::Tree declarations;
+    Ctx ctx;
+};
+
+using AstParser = BasicParser<AstBuilder>;
+
+}  // namespace ast
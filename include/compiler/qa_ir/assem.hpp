@@ -17,8 +17,8 @@
 namespace qa_ir {
 
 struct Frame {
-    std::string name;
-    std::vector<Operation> instructions;
+    std::string name = "";
+    std::vector<Operation> instructions = {};
     int size = 0;
 };
 
@@ -41,6 +41,7 @@ struct F_Ctx {
     }
 };
 
+[[nodiscard]] auto Produce_IR(ast::TopLevelNode& node) -> Frame;
 [[nodiscard]] auto Produce_IR(std::vector<ast::TopLevelNode>& nodes) -> std::vector<Frame>;
 
 }  // namespace qa_ir
\ No newline at end of file
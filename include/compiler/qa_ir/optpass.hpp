@@ -5,5 +5,6 @@
 #include "assem.hpp"
 
 namespace qa_ir {
+Frame move_from_temp_dest_pass(const Frame& frame);
 std::vector<Frame> move_from_temp_dest_pass(const std::vector<Frame>& frames);
 }
\ No newline at end of file
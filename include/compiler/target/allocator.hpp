@@ -19,5 +19,6 @@ struct FirstLastUse {
     std::map<int, int> lastUse = {};
 };
 
+[[nodiscard]] auto rewrite(const Frame& frame) -> Frame;
 [[nodiscard]] auto rewrite(const std::vector<Frame>& frames) -> std::vector<Frame>;
 }  // namespace target
\ No newline at end of file
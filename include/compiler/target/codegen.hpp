@@ -7,6 +7,17 @@
 
 namespace target {
 
+// assembly of a single function, see CodegenContext for how float constants stay unique
+struct FrameAsm {
+    std::string data = "";
+    std::string code = "";
+};
+
+[[nodiscard]] FrameAsm GenerateFrame(const target::Frame& frame);
+
+// joins the frames in the given order and adds the program entry point
+[[nodiscard]] std::string EmitProgram(const std::vector<FrameAsm>& frames);
+
 [[nodiscard]] std::string Generate(const std::vector<target::Frame>& frames);
 
 }
\ No newline at end of file
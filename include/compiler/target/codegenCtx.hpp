@@ -1,12 +1,18 @@
 #pragma once
 
 #include <string>
+#include <utility>
 
 namespace target {
 
 class CodegenContext {
    public:
-    std::string DataSection = "section .data\n";
+    CodegenContext() = default;
+    // float constants are named after the frame, so frames can be emitted independently and
+    // their data sections joined without label collisions
+    explicit CodegenContext(std::string p_frame_name) : frame_name(std::move(p_frame_name)) {}
+
+    std::string DataSection = "";
     std::string Code = "";
 
     void AddInstructionNoIndent(const std::string& i);
@@ -16,6 +22,7 @@ class CodegenContext {
     std::string DefineFloatConstant(float value);
 
    private:
+    std::string frame_name = "";
     int float_counter = 0;
 };
 }  // namespace target
\ No newline at end of file
@@ -50,5 +50,6 @@ template <ast::BaseType T, ast::BaseType U>
 [[nodiscard]] auto LowerInstruction(qa_ir::ConditionalJumpLess cj, Ctx& ctx) -> ins_list;
 [[nodiscard]] auto LowerInstruction(qa_ir::LabelDef label, Ctx& ctx) -> ins_list;
 
+[[nodiscard]] Frame LowerIR(const qa_ir::Frame& frame);
 [[nodiscard]] std::vector<Frame> LowerIR(const std::vector<qa_ir::Frame>& ops);
 }  // namespace target
\ No newline at end of file
@@ -7,8 +7,8 @@
 
 namespace target {
 struct Frame {
-    std::string name;
-    std::vector<Instruction> instructions;
+    std::string name = "";
+    std::vector<Instruction> instructions = {};
     int size = 0;
 };
 }  // namespace target
\ No newline at end of file
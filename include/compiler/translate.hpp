@@ -1,48 +1,116 @@
 #pragma once
 
+#include <cstddef>
 #include <iostream>
 #include <memory>
+#include <span>
 #include <stdexcept>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
 #include "../ast/ast.hpp"
 #include "../parser/st.hpp"
 
+namespace support {
+class ThreadPool;
+}  // namespace support
+
 namespace ast {
 
+using Variables = std::unordered_map<std::string, std::shared_ptr<VariableAstNode>>;
+
+// The variables each part of a program declares, so that a part can be translated as if the parts
+// before it had been, without waiting for them. See translate_parts().
+class DeclarationHistory {
+   public:
+    // what translating part `part` adds to Ctx::local_variables; parts are added in order
+    void add(std::size_t part, const Variables& declared);
+    // the variable `name` refers to where part `part` starts, nullptr if none
+    [[nodiscard]] auto find(const std::string& name, std::size_t part) const
+        -> const VariableAstNode*;
+
+   private:
+    // by name, the parts declaring it in order
+    std::unordered_map<std::string,
+                       std::vector<std::pair<std::size_t, std::shared_ptr<VariableAstNode>>>>
+        declarations = {};
+};
+
 struct Ctx {
+    // the syntax tree the nodes being translated live in
+    const st::Tree* tree = nullptr;
     unsigned long counter = 0;
     bool __lvalueContext = false;
     std::unordered_map<std::string, std::shared_ptr<VariableAstNode>> local_variables;
+    // when translating part `part` of a program on its own, what the names it does not declare
+    // refer to
+    const DeclarationHistory* earlier_parts = nullptr;
+    std::size_t part = 0;
+    // __lvalueContext was set, or read before that and so taken from the earlier parts
+    bool lvalue_context_set = false;
+    bool lvalue_context_inherited = false;
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
-    void set_lvalueContext(std::string why, bool value) { __lvalueContext = value; }
+    void set_lvalueContext(std::string_view why, bool value) {
+        __lvalueContext = value;
+        lvalue_context_set = true;
+    }
 #pragma GCC diagnostic pop
+    [[nodiscard]] auto lvalueContext() -> bool {
+        lvalue_context_inherited = lvalue_context_inherited || !lvalue_context_set;
+        return __lvalueContext;
+    }
+    // the variable `name` refers to at this point, nullptr if none
+    [[nodiscard]] auto find_variable(const std::string& name) const -> const VariableAstNode*;
 };
 
 [[nodiscard]] auto translate(const st::Expression& expr, Ctx& ctx) -> ExprNode;
-[[nodiscard]] auto translate(const std::unique_ptr<st::ExpressionStatement>& stmt, Ctx& ctx)
-    -> Stmt;
-[[nodiscard]] auto translate(const std::unique_ptr<st::SelectionStatement>& stmt, Ctx& ctx)
-    -> ast::Stmt;
-[[nodiscard]] auto translate(const std::unique_ptr<st::UnaryExpression>& expr, Ctx& ctx) -> Stmt;
-[[nodiscard]] auto translate(const std::unique_ptr<st::ForStatement>& stmt, Ctx& ctx) -> Stmt;
-[[nodiscard]] auto translate(const std::unique_ptr<st::AssignmentExpression>& expr, Ctx& ctx)
-    -> Stmt;
-[[nodiscard]] auto translate(st::CompoundStatement& stmts, Ctx& ctx) -> std::vector<BodyNode>;
-[[nodiscard]] auto translate(const std::unique_ptr<st::ReturnStatement>& stmt, Ctx& ctx) -> Stmt;
-[[nodiscard]] auto translate(const std::unique_ptr<st::AdditiveExpression>& expr, Ctx& ctx) -> Stmt;
-[[nodiscard]] auto translate(const std::unique_ptr<st::PrimaryExpression>& expr, Ctx& ctx) -> Stmt;
-
-[[nodiscard]] auto translateStatement(st::Statement& stmt, Ctx& ctx) -> ast::Stmt;
-[[nodiscard]] auto translate(st::FuncDef* fd, Ctx& ctx) -> std::shared_ptr<FrameAstNode>;
-
-[[nodiscard]] auto translate(const std::unique_ptr<st::FunctionCallExpression>& expr, Ctx& ctx)
-    -> Stmt;
+[[nodiscard]] auto translate(const st::ExpressionStatement& stmt, Ctx& ctx) -> Stmt;
+[[nodiscard]] auto translate(const st::SelectionStatement& stmt, Ctx& ctx) -> ast::Stmt;
+[[nodiscard]] auto translate(const st::UnaryExpression& expr, Ctx& ctx) -> ExprNode;
+[[nodiscard]] auto translate(const st::ForStatement& stmt, Ctx& ctx) -> Stmt;
+[[nodiscard]] auto translate(const st::AssignmentExpression& expr, Ctx& ctx) -> ExprNode;
+[[nodiscard]] auto translate(const st::CompoundStatement& stmts, Ctx& ctx)
+    -> std::vector<BodyNode>;
+[[nodiscard]] auto translate(const st::ReturnStatement& stmt, Ctx& ctx) -> Stmt;
+[[nodiscard]] auto translate(const st::AdditiveExpression& expr, Ctx& ctx) -> ExprNode;
+[[nodiscard]] auto translate(const st::PrimaryExpression& expr, Ctx& ctx) -> ExprNode;
+
+[[nodiscard]] auto translateStatement(const st::Statement& stmt, Ctx& ctx) -> ast::Stmt;
+[[nodiscard]] auto translate(const st::FuncDef& fd, Ctx& ctx) -> std::shared_ptr<FrameAstNode>;
+
+[[nodiscard]] auto translate(const st::FunctionCallExpression& expr, Ctx& ctx) -> ExprNode;
 
 [[nodiscard]] auto translate(const st::Declaration& decl, Ctx& ctx) -> std::shared_ptr<MoveAstNode>;
 [[nodiscard]] auto translate(const st::ExternalDeclaration& node, Ctx& ctx) -> ast::TopLevelNode;
 [[nodiscard]] std::vector<TopLevelNode> translate(const st::Program& program);
+// The same as translate() of the program the parts were parsed from, in order, but translated on
+// `pool`. Names and the lvalue context carry over from one external declaration to the next, so
+// each part first gets what the parts before it declare and then starts from a guess of the
+// context they leave; the few parts whose result depends on a wrong guess are redone in order.
+[[nodiscard]] auto translate_parts(std::span<const st::Program> parts, support::ThreadPool& pool)
+    -> std::vector<TopLevelNode>;
+
+// The steps translate() is made of, shared with AstBuilder which runs them while parsing.
+// Operands come already translated. Names resolve through ctx.find_variable(), so the steps have
+// to run in source order.
+
+// reads or writes a[index] depending on ctx.__lvalueContext
+[[nodiscard]] auto array_access(std::string_view name, ExprNode index, Ctx& ctx) -> ExprNode;
+// `literal` is the operand if it is a number or a name in the source, so that -1 is a constant
+[[nodiscard]] auto unary_operation(st::UnaryExpressionType type, ExprNode operand,
+                                   const st::PrimaryExpression* literal, Ctx& ctx) -> ExprNode;
+[[nodiscard]] auto function_call(std::string_view name, std::vector<ExprNode> args) -> ExprNode;
+// if (a) becomes if (a != 0)
+[[nodiscard]] auto translate_condition(ExprNode condition, Ctx& ctx)
+    -> std::shared_ptr<BinaryOpAstNode>;
+[[nodiscard]] auto expression_statement(const ExprNode& expr) -> Stmt;
+// the variable `decl` introduces, visible to the names after it; `decl` lives in ctx.tree
+[[nodiscard]] auto declare_variable(const st::Declaration& decl, Ctx& ctx)
+    -> std::shared_ptr<VariableAstNode>;
+// the parameters of `fd`, visible to the names in its body
+[[nodiscard]] auto declare_parameters(const st::FuncDef& fd, Ctx& ctx) -> std::vector<FrameParam>;
 }  // namespace ast
\ No newline at end of file
@@ -1,3 +1,56 @@
 #pragma once
 
-[[nodiscard]] int runfile(const char* sourcefile, const std::string& outfile);
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace support {
+class ThreadPool;
+class TimeReport;
+}  // namespace support
+
+enum class DumpStage { ST, AST, IR, OPT_IR, TARGET_IR };
+
+struct DriverOptions {
+    // stages whose intermediate representation is written next to the output file
+    std::set<DumpStage> dumps = {};
+    // print per phase wall/cpu time, process peak rss growth and object counts to stderr
+    bool time_report = false;
+    // also write the time report as json to this path
+    std::optional<std::string> time_report_json = std::nullopt;
+    // threads shared by the translation units given to runfiles() and the functions of each
+    unsigned jobs = 1;
+    // reuse assembly cached in this directory for sources compiled before
+    std::optional<std::string> cache_dir = std::nullopt;
+    // least recently used entries are evicted once the cache grows past this
+    std::uintmax_t cache_max_bytes = std::uintmax_t{256} << 20;
+    // parse straight into the ast instead of through a syntax tree, unless dumping the latter
+    bool fused_front_end = false;
+    // parse and translate runs of functions on the pool, unless dumping the syntax tree; takes
+    // precedence over fused_front_end
+    bool parallel_front_end = false;
+};
+
+// parses the comma separated list given to --dump, e.g. "st,ast,target-ir"
+[[nodiscard]] auto parse_dump_stages(std::string_view list) -> std::optional<std::set<DumpStage>>;
+
+void write_to_file(const std::string& code, const std::string& outfile);
+
+// Runs every phase from lexing to code generation on `source` and returns the assembly. Stages
+// in options.dumps are written to <dump_prefix>.<stage>. Invalid input throws
+// std::runtime_error.
+[[nodiscard]] auto compile_to_assembly(std::string_view source, const DriverOptions& options,
+                                       const std::string& dump_prefix,
+                                       support::TimeReport& report, support::ThreadPool& pool)
+    -> std::string;
+
+[[nodiscard]] int runfile(const char* sourcefile, const std::string& outfile,
+                          const DriverOptions& options);
+
+// Compiles every source into <outdir>/<name>.asm on options.jobs threads. Diagnostics are
+// printed in input order once all files are done, so the output does not depend on -j.
+[[nodiscard]] int runfiles(const std::vector<std::string>& sourcefiles, const std::string& outdir,
+                           const DriverOptions& options);
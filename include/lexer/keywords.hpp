@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+#include "token.hpp"
+
+namespace lexer {
+
+struct Keyword {
+    std::string_view text;
+    TokType type;
+};
+
+// Add new keywords here; the perfect hash below is recomputed at compile time and the build
+// fails if it cannot be found for the table size.
+inline constexpr std::array keyword_list = {
+    Keyword{"return", TokType::TOKEN_RETURN}, Keyword{"int", TokType::TOKEN_T_INT},
+    Keyword{"else", TokType::TOKEN_ELSE},     Keyword{"if", TokType::TOKEN_IF},
+    Keyword{"for", TokType::TOKEN_FOR},       Keyword{"void", TokType::TOKEN_T_VOID},
+    Keyword{"double", TokType::TOKEN_T_DOUBLE}, Keyword{"float", TokType::TOKEN_T_FLOAT},
+};
+
+namespace detail {
+
+// a power of two, at least twice the number of keywords keeps a seed easy to find
+inline constexpr std::size_t keyword_table_size = 32;
+static_assert(keyword_list.size() * 2 <= keyword_table_size);
+
+// Mixes the length with the first, second and last character, which already tells the C
+// keywords apart, so hashing an identifier costs four multiplications whatever its length.
+[[nodiscard]] constexpr auto keyword_slot(std::string_view text, std::uint32_t seed)
+    -> std::size_t {
+    std::uint32_t h = seed ^ 2166136261u;
+    const auto mix = [&h](std::uint32_t value) { h = (h ^ value) * 16777619u; };
+    mix(static_cast<std::uint32_t>(text.size()));
+    mix(static_cast<unsigned char>(text.front()));
+    mix(static_cast<unsigned char>(text.size() > 1 ? text[1] : 0));
+    mix(static_cast<unsigned char>(text.back()));
+    return (h ^ (h >> 15)) & (keyword_table_size - 1);
+}
+
+inline constexpr std::uint32_t no_seed = std::numeric_limits<std::uint32_t>::max();
+
+[[nodiscard]] consteval auto find_keyword_seed() -> std::uint32_t {
+    for (std::uint32_t seed = 0; seed < 10000; seed++) {
+        std::array<bool, keyword_table_size> used = {};
+        bool collision = false;
+        for (const auto& keyword : keyword_list) {
+            const auto slot = keyword_slot(keyword.text, seed);
+            collision = collision || used[slot];
+            used[slot] = true;
+        }
+        if (!collision) {
+            return seed;
+        }
+    }
+    return no_seed;
+}
+
+inline constexpr std::uint32_t keyword_seed = find_keyword_seed();
+static_assert(keyword_seed != no_seed, "no perfect hash for keyword_list, grow the table");
+
+[[nodiscard]] consteval auto build_keyword_table() -> std::array<Keyword, keyword_table_size> {
+    std::array<Keyword, keyword_table_size> table = {};
+    table.fill(Keyword{"", TokType::TOKEN_IDENTIFIER});
+    for (const auto& keyword : keyword_list) {
+        table[keyword_slot(keyword.text, keyword_seed)] = keyword;
+    }
+    return table;
+}
+
+inline constexpr auto keyword_table = build_keyword_table();
+
+}  // namespace detail
+
+// The keyword token for `text`, or TOKEN_IDENTIFIER. One hash and at most one comparison.
+[[nodiscard]] constexpr auto keyword_type(std::string_view text) -> TokType {
+    if (text.empty()) {
+        return TokType::TOKEN_IDENTIFIER;
+    }
+    const auto& entry = detail::keyword_table[detail::keyword_slot(text, detail::keyword_seed)];
+    return entry.text == text ? entry.type : TokType::TOKEN_IDENTIFIER;
+}
+
+static_assert([] {
+    for (const auto& keyword : keyword_list) {
+        if (keyword_type(keyword.text) != keyword.type) {
+            return false;
+        }
+    }
+    return keyword_type("main") == TokType::TOKEN_IDENTIFIER &&
+           keyword_type("in") == TokType::TOKEN_IDENTIFIER;
+}());
+
+}  // namespace lexer
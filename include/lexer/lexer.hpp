@@ -1,12 +1,63 @@
 #pragma once
 
-#include <string>
+#include <cstddef>
+#include <optional>
+#include <string_view>
 #include <vector>
 
+#include "scan.hpp"
 #include "token.hpp"
+
+namespace support {
+class ThreadPool;
+}
+
 namespace lexer {
-[[nodiscard]] auto peek() -> char;
-[[nodiscard]] auto isAtEnd() -> bool;
-auto advance() -> char;
-[[nodiscard]] auto lex(const std::string& source) -> std::vector<Token>;
+
+// Lexes one buffer. All cursor state lives in the object, so any number of lexers can run at
+// once, on different files or on different parts of one file. Tokens point into the buffer,
+// which must outlive them.
+class Lexer {
+   public:
+    // throws std::runtime_error for buffers of 4 GiB or more, which token offsets cannot address
+    explicit Lexer(std::string_view p_source);
+    // Lexes only [p_begin, p_end), which must start at the beginning of a line. Token offsets
+    // stay relative to the whole buffer, lines are counted from the start of the range.
+    Lexer(std::string_view p_source, std::size_t p_begin, std::size_t p_end);
+
+    // The next token, TOKEN_FEOF at the end of the buffer and on every call after that. Throws
+    // std::runtime_error on a character that starts no token.
+    [[nodiscard]] auto next() -> Token;
+
+    // the line the lexer is on, 1 until it passes the first newline
+    [[nodiscard]] auto line_number() const -> unsigned long { return line; }
+
+   private:
+    [[nodiscard]] auto isAtEnd() const -> bool { return current >= source.size(); }
+    [[nodiscard]] auto peek() const -> char;
+    [[nodiscard]] auto peekNext() const -> char;
+    auto advance() -> char;
+    [[nodiscard]] auto make_token(TokType type) const -> Token;
+    template <auto Continues>
+    void skip(decltype(Scanner::skip_blanks) scan);
+    [[nodiscard]] auto number() -> Token;
+    [[nodiscard]] auto scanToken() -> std::optional<Token>;
+
+    std::string_view source;
+    const Scanner* scanner;
+    unsigned long current = 0;
+    unsigned long start = 0;
+    unsigned long line = 1;
+    unsigned long line_start = 0;
+};
+
+// the whole buffer at once, ending with TOKEN_FEOF
+[[nodiscard]] auto lex(std::string_view source) -> std::vector<Token>;
+
+// lex_parallel() gives every thread at least this much of the buffer
+inline constexpr std::size_t parallel_lex_min_chunk = 256 * 1024;
+
+// The same tokens as lex(), and the same error, from chunks of the buffer lexed on `pool`.
+[[nodiscard]] auto lex_parallel(std::string_view source, support::ThreadPool& pool)
+    -> std::vector<Token>;
 }  // namespace lexer
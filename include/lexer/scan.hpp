@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+namespace lexer {
+
+// The lexer's inner loops. Each function returns the first position in [p, end) that does not
+// continue the run, or `end`; they never read outside [p, end), so a mapped file can be scanned
+// up to its last byte.
+struct Scanner {
+    std::string_view name;
+    // spaces, tabs and carriage returns; newlines are left to the caller, which counts lines
+    auto (*skip_blanks)(const char* p, const char* end) -> const char*;
+    auto (*find_newline)(const char* p, const char* end) -> const char*;
+    // [A-Za-z0-9_]
+    auto (*identifier_end)(const char* p, const char* end) -> const char*;
+    auto (*digits_end)(const char* p, const char* end) -> const char*;
+};
+
+// the fastest scanner this CPU supports, chosen once through CPUID
+[[nodiscard]] auto active_scanner() -> const Scanner&;
+
+// every scanner this CPU can run, the portable scalar one first
+[[nodiscard]] auto available_scanners() -> std::vector<Scanner>;
+
+}  // namespace lexer
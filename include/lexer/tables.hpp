@@ -0,0 +1,162 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "token.hpp"
+
+namespace lexer {
+
+// Compile-time tables behind Lexer::scanToken(): a class for every byte, which picks the
+// scanning routine, and a DFA over the operators, which finds the longest operator at a
+// position. A new operator is a new entry in operator_list.
+
+struct Operator {
+    std::string_view text;
+    TokType type;
+};
+
+inline constexpr std::array operator_list = {
+    Operator{"(", TokType::TOKEN_LEFT_PAREN},     Operator{")", TokType::TOKEN_RIGHT_PAREN},
+    Operator{"{", TokType::TOKEN_LEFT_BRACE},     Operator{"}", TokType::TOKEN_RIGHT_BRACE},
+    Operator{"[", TokType::TOKEN_LEFT_BRACKET},   Operator{"]", TokType::TOKEN_RIGHT_BRACKET},
+    Operator{",", TokType::TOKEN_COMMA},          Operator{".", TokType::TOKEN_DOT},
+    Operator{"-", TokType::TOKEN_MINUS},          Operator{"+", TokType::TOKEN_PLUS},
+    Operator{";", TokType::TOKEN_SEMICOLON},      Operator{"/", TokType::TOKEN_SLASH},
+    Operator{"*", TokType::TOKEN_STAR},           Operator{"&", TokType::TOKEN_AMPERSAND},
+    Operator{"!", TokType::TOKEN_BANG},           Operator{"!=", TokType::TOKEN_BANG_EQUAL},
+    Operator{"=", TokType::TOKEN_EQUAL},          Operator{"==", TokType::TOKEN_EQUAL_EQUAL},
+    Operator{">", TokType::TOKEN_GREATER},        Operator{">=", TokType::TOKEN_GREATER_EQUAL},
+    Operator{"<", TokType::TOKEN_LESS},           Operator{"<=", TokType::TOKEN_LESS_EQUAL},
+};
+
+enum class CharClass : std::uint8_t { INVALID, BLANK, NEWLINE, NUL, DIGIT, ALPHA, OPERATOR };
+
+namespace detail {
+
+// operator characters are numbered from 1, 0 means the byte starts no operator
+[[nodiscard]] consteval auto build_operator_chars() -> std::array<std::uint8_t, 256> {
+    std::array<std::uint8_t, 256> index = {};
+    std::uint8_t next = 1;
+    for (const auto& op : operator_list) {
+        for (const char c : op.text) {
+            auto& slot = index[static_cast<unsigned char>(c)];
+            if (slot == 0) {
+                slot = next++;
+            }
+        }
+    }
+    return index;
+}
+
+inline constexpr auto operator_chars = build_operator_chars();
+
+[[nodiscard]] consteval auto count_operator_chars() -> std::size_t {
+    std::size_t count = 0;
+    for (const auto index : operator_chars) {
+        count = index > count ? index : count;
+    }
+    return count;
+}
+
+// the start state plus at most one state per operator character
+inline constexpr std::size_t max_operator_states = [] {
+    std::size_t states = 1;
+    for (const auto& op : operator_list) {
+        states += op.text.size();
+    }
+    return states;
+}();
+
+struct OperatorDfa {
+    // next[state][operator char], 0 when the DFA has no move; state 0 is the start
+    std::array<std::array<std::uint8_t, count_operator_chars() + 1>, max_operator_states> next;
+    // the token for the operator ending in a state, TOKEN_FEOF for states that end none
+    std::array<TokType, max_operator_states> accepts;
+};
+
+static_assert(max_operator_states <= 256, "operator DFA states no longer fit a byte");
+
+// a trie of the operators, which is a DFA for the longest operator at a position
+[[nodiscard]] consteval auto build_operator_dfa() -> OperatorDfa {
+    OperatorDfa dfa = {};
+    dfa.accepts.fill(TokType::TOKEN_FEOF);
+    std::uint8_t states = 1;
+    for (const auto& op : operator_list) {
+        std::uint8_t state = 0;
+        for (const char c : op.text) {
+            auto& next = dfa.next[state][operator_chars[static_cast<unsigned char>(c)]];
+            if (next == 0) {
+                next = states++;
+            }
+            state = next;
+        }
+        dfa.accepts[state] = op.type;
+    }
+    return dfa;
+}
+
+inline constexpr auto operator_dfa = build_operator_dfa();
+
+[[nodiscard]] consteval auto build_char_classes() -> std::array<CharClass, 256> {
+    std::array<CharClass, 256> classes = {};
+    for (std::size_t c = 0; c < classes.size(); c++) {
+        if (operator_chars[c] != 0) {
+            classes[c] = CharClass::OPERATOR;
+        } else if (c >= '0' && c <= '9') {
+            classes[c] = CharClass::DIGIT;
+        } else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+            classes[c] = CharClass::ALPHA;
+        }
+    }
+    classes[' '] = classes['\t'] = classes['\r'] = CharClass::BLANK;
+    classes['\n'] = CharClass::NEWLINE;
+    classes['\0'] = CharClass::NUL;
+    return classes;
+}
+
+inline constexpr auto char_classes = build_char_classes();
+
+}  // namespace detail
+
+[[nodiscard]] constexpr auto char_class(char c) -> CharClass {
+    return detail::char_classes[static_cast<unsigned char>(c)];
+}
+
+struct OperatorMatch {
+    TokType type = TokType::TOKEN_FEOF;
+    std::size_t length = 0;
+};
+
+// The longest operator `text` starts with, of length 0 when there is none.
+[[nodiscard]] constexpr auto match_operator(std::string_view text) -> OperatorMatch {
+    OperatorMatch match = {};
+    std::uint8_t state = 0;
+    for (std::size_t i = 0; i < text.size(); i++) {
+        const auto c = detail::operator_chars[static_cast<unsigned char>(text[i])];
+        state = c == 0 ? 0 : detail::operator_dfa.next[state][c];
+        if (state == 0) {
+            break;
+        }
+        if (detail::operator_dfa.accepts[state] != TokType::TOKEN_FEOF) {
+            match = OperatorMatch{.type = detail::operator_dfa.accepts[state], .length = i + 1};
+        }
+    }
+    return match;
+}
+
+static_assert([] {
+    for (const auto& op : operator_list) {
+        const auto match = match_operator(op.text);
+        if (match.type != op.type || match.length != op.text.size() ||
+            char_class(op.text.front()) != CharClass::OPERATOR) {
+            return false;
+        }
+    }
+    return match_operator("<=>").length == 2 && match_operator("=<").length == 1 &&
+           match_operator("x").length == 0 && char_class('_') == CharClass::INVALID;
+}());
+
+}  // namespace lexer
@@ -1,6 +1,8 @@
 #pragma once
 
-#include <string>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
 
 enum TokType {
     TOKEN_LEFT_PAREN,
@@ -33,7 +35,9 @@ enum TokType {
 
     // Literals.
     TOKEN_IDENTIFIER,
+    // an integer literal
     TOKEN_NUMBER,
+    TOKEN_FLOAT_NUMBER,
 
     // Keywords.
     TOKEN_RETURN,
@@ -50,7 +54,23 @@ enum TokType {
     TOKEN_FEOF
 };
 
+// A token points into the source buffer instead of owning its text, so lexing allocates nothing
+// per token; lexeme() slices the text out when it is actually needed.
 struct Token {
-    TokType type;
-    std::string lexeme;
+    TokType type = TOKEN_FEOF;
+    std::uint32_t offset = 0;
+    std::uint32_t length = 0;
+    std::uint32_t line = 0;
+    std::uint32_t column = 0;
+    // the value of a TOKEN_NUMBER or TOKEN_FLOAT_NUMBER, converted once by the lexer
+    union {
+        int int_value = 0;
+        float float_value;
+    };
+
+    [[nodiscard]] auto lexeme(std::string_view source) const -> std::string_view {
+        return source.substr(offset, length);
+    }
 };
+
+static_assert(std::is_trivially_copyable_v<Token>);
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "../lexer/token.hpp"
+
+// Compile-time table behind Parser::parseBinaryExpression(), a precedence climbing loop. A new
+// binary operator is an entry in binary_operator_list plus, for a new kind of node, a case in
+// the builders' binary().
+
+enum class BinaryOp : std::uint8_t { NONE, ASSIGN, EQ, NEQ, LT, GT, ADD, SUB, MUL, DIV };
+
+// NON_ASSOCIATIVE operators do not chain: `a < b < c` is a syntax error, as `a = b = c` is
+enum class Associativity : std::uint8_t { LEFT, RIGHT, NON_ASSOCIATIVE };
+
+struct BinaryOperator {
+    TokType token = TokType::TOKEN_FEOF;
+    // higher binds tighter, 0 means the token is not a binary operator
+    std::uint8_t binding_power = 0;
+    Associativity associativity = Associativity::LEFT;
+    BinaryOp op = BinaryOp::NONE;
+};
+
+inline constexpr std::array binary_operator_list = {
+    BinaryOperator{TokType::TOKEN_EQUAL, 1, Associativity::NON_ASSOCIATIVE, BinaryOp::ASSIGN},
+    BinaryOperator{TokType::TOKEN_EQUAL_EQUAL, 2, Associativity::NON_ASSOCIATIVE, BinaryOp::EQ},
+    BinaryOperator{TokType::TOKEN_BANG_EQUAL, 2, Associativity::NON_ASSOCIATIVE, BinaryOp::NEQ},
+    BinaryOperator{TokType::TOKEN_LESS, 3, Associativity::NON_ASSOCIATIVE, BinaryOp::LT},
+    BinaryOperator{TokType::TOKEN_GREATER, 3, Associativity::NON_ASSOCIATIVE, BinaryOp::GT},
+    BinaryOperator{TokType::TOKEN_PLUS, 4, Associativity::LEFT, BinaryOp::ADD},
+    BinaryOperator{TokType::TOKEN_MINUS, 4, Associativity::LEFT, BinaryOp::SUB},
+    BinaryOperator{TokType::TOKEN_STAR, 5, Associativity::LEFT, BinaryOp::MUL},
+    BinaryOperator{TokType::TOKEN_SLASH, 5, Associativity::LEFT, BinaryOp::DIV},
+};
+
+namespace detail {
+
+[[nodiscard]] consteval auto build_binary_operators()
+    -> std::array<BinaryOperator, TokType::TOKEN_FEOF + 1> {
+    std::array<BinaryOperator, TokType::TOKEN_FEOF + 1> table = {};
+    for (const auto& entry : binary_operator_list) {
+        table[entry.token] = entry;
+    }
+    return table;
+}
+
+inline constexpr auto binary_operators = build_binary_operators();
+
+}  // namespace detail
+
+// the operator `type` stands for between two operands, binding_power 0 if none
+[[nodiscard]] constexpr auto binary_operator(TokType type) -> const BinaryOperator& {
+    return detail::binary_operators[type];
+}
+
+static_assert([] {
+    for (const auto& entry : binary_operator_list) {
+        if (entry.binding_power == 0 || binary_operator(entry.token).op != entry.op) {
+            return false;
+        }
+    }
+    return binary_operator(TokType::TOKEN_SEMICOLON).binding_power == 0;
+}());
@@ -1,47 +1,129 @@
 #pragma once
 
+#include <cstdint>
+#include <optional>
+#include <source_location>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
 #include <vector>
 
 #include "../lexer/token.hpp"
 #include "st.hpp"
+#include "token_stream.hpp"
+#include "tree_builder.hpp"
 
-[[nodiscard]] auto parseDirectDeclartor() -> st::DirectDeclarator;
-[[nodiscard]] auto parseDeclaration() -> st::Declaration;
-[[nodiscard]] auto parseDeclarator() -> st::Declarator;
-[[nodiscard]] auto parseCompoundStatement() -> st::CompoundStatement;
-[[nodiscard]] auto parseExpression() -> st::Expression;
-[[nodiscard]] auto peek() -> Token;
-[[nodiscard]] auto peekn(size_t n) -> Token;
-auto advance() -> Token;
-[[nodiscard]] auto previous() -> Token;
-[[nodiscard]] auto match(TokType type) -> bool;
-[[nodiscard]] auto isAtEnd() -> bool;
-
-auto consume(TokType typ) -> void;
-
-[[nodiscard]] auto parseDeclarationSpecs() -> std::vector<st::DeclarationSpecifier>;
-[[nodiscard]] auto parsePointer() -> std::optional<st::Pointer>;
-[[nodiscard]] auto parseIdentifier() -> std::string;
-[[nodiscard]] auto parseParamTypeList() -> st::ParamTypeList;
-
-[[nodiscard]] auto parsePrimaryExpression() -> st::Expression;
-[[nodiscard]] auto parseReturnStatement() -> std::shared_ptr<st::ReturnStatement>;
-[[nodiscard]] auto parseExpressionStatement() -> std::shared_ptr<st::ExpressionStatement>;
-[[nodiscard]] auto parseStatement() -> st::Statement;
-[[nodiscard]] auto parseIfStatement() -> std::shared_ptr<st::SelectionStatement>;
-[[nodiscard]] auto parseBlockItem() -> st::BlockItem;
-[[nodiscard]] auto parseInitalizer() -> st::Initalizer;
-[[nodiscard]] auto parseInitDeclarator() -> st::InitDeclarator;
-[[nodiscard]] auto parseFunctionDefinition() -> std::shared_ptr<st::FuncDef>;
-[[nodiscard]] auto parseExternalDeclaration() -> std::optional<st::ExternalDeclaration>;
-[[nodiscard]] auto parse(const std::vector<Token>& tokens) -> st::Program;
-[[nodiscard]] auto parsePostfixExpression() -> st::Expression;
-[[nodiscard]] auto parseUnaryExpression() -> st::Expression;
-[[nodiscard]] auto parseAdditiveExpression() -> st::Expression;
-[[nodiscard]] auto parseRelationalExpression() -> st::Expression;
-[[nodiscard]] auto parseEqualityExpression() -> st::Expression;
-[[nodiscard]] auto parseAssignmentExpression() -> st::Expression;
-[[nodiscard]] auto parseForStatement() -> std::shared_ptr<st::ForStatement>;
-[[nodiscard]] auto parseForDeclaration() -> st::ForDeclaration;
-
-[[nodiscard]] st::Program parse(const std::vector<Token>& tokens);
\ No newline at end of file
+// tokens [begin, end) of one external declaration, see BasicParser::outlineProgram()
+struct TokenRange {
+    std::size_t begin = 0;
+    std::size_t end = 0;
+};
+
+// An external declaration that does not parse to where the outline says it ends.
+class OutlineMismatch : public std::runtime_error {
+   public:
+    using std::runtime_error::runtime_error;
+};
+
+// Parses one translation unit. The parser owns its cursor into the tokens and keeps no state
+// elsewhere, so any number of parsers can run at once.
+//
+// What the parser produces is up to `Builder`, which it hands every construct once complete:
+// st::TreeBuilder keeps the syntax tree, ast::AstBuilder translates as it goes. Declarators are
+// st:: values either way, their lists kept in builder.syntax_tree(). Builders are instantiated
+// at the end of parser.cpp.
+template <typename Builder>
+class BasicParser {
+   public:
+    using Expression = typename Builder::Expression;
+    using Statement = typename Builder::Statement;
+    using BlockItem = typename Builder::BlockItem;
+    using CompoundStatement = typename Builder::CompoundStatement;
+    using Declaration = typename Builder::Declaration;
+    using ExternalDeclaration = typename Builder::ExternalDeclaration;
+    using Program = typename Builder::Program;
+
+    // `source` is the buffer the tokens point into; neither is copied
+    BasicParser(std::span<const Token> p_tokens, std::string_view p_source);
+    // lexes `p_source` while parsing, see TokenStream
+    explicit BasicParser(std::string_view p_source);
+
+    [[nodiscard]] auto parseProgram() -> Program;
+
+    // Where each external declaration starts and ends, found without parsing function bodies:
+    // those are skipped by matching braces. The declarations can then be parsed independently
+    // with parseExternalDeclarations(). Only for tokens lexed up front.
+    [[nodiscard]] auto outlineProgram() -> std::vector<TokenRange>;
+    // Parses consecutive declarations of an outline as a program. Throws OutlineMismatch if one
+    // does not end where the outline says, e.g. over unbalanced braces; only parseProgram() knows
+    // what such input means.
+    [[nodiscard]] auto parseExternalDeclarations(std::span<const TokenRange> ranges) -> Program;
+
+    [[nodiscard]] auto tokens() const -> const TokenStream& { return stream; }
+
+   private:
+    // references into the token stream, see TokenStream::peek() for how long they stay valid
+    [[nodiscard]] auto peek() -> const Token&;
+    [[nodiscard]] auto peekn(size_t n) -> const Token&;
+    auto advance() -> Token;
+    [[nodiscard]] auto previous() const -> const Token&;
+    [[nodiscard]] auto match(TokType type) -> bool;
+    [[nodiscard]] auto isAtEnd() -> bool;
+    auto consume(TokType typ) -> void;
+    [[nodiscard]] auto lexeme(const Token& tk) const -> std::string_view;
+    auto parser_log(const char* msg,
+                    const std::source_location loc = std::source_location::current()) -> void;
+
+    [[nodiscard]] auto parseDirectDeclartor() -> st::DirectDeclarator;
+    [[nodiscard]] auto parseDeclaration() -> Declaration;
+    [[nodiscard]] auto parseDeclarator() -> st::Declarator;
+    [[nodiscard]] auto parseCompoundStatement() -> CompoundStatement;
+    [[nodiscard]] auto parseExpression() -> Expression;
+    [[nodiscard]] auto parseDeclarationSpecs() -> st::NodeList<st::DeclarationSpecifier>;
+    [[nodiscard]] auto parsePointer() -> std::optional<st::Pointer>;
+    [[nodiscard]] auto parseIdentifier() -> std::string_view;
+    [[nodiscard]] auto parseParamTypeList() -> st::ParamTypeList;
+    [[nodiscard]] auto parsePrimaryExpression() -> Expression;
+    [[nodiscard]] auto parseReturnStatement() -> Statement;
+    [[nodiscard]] auto parseExpressionStatement() -> Statement;
+    [[nodiscard]] auto parseStatement() -> Statement;
+    [[nodiscard]] auto parseIfStatement() -> Statement;
+    [[nodiscard]] auto parseBlockItem() -> BlockItem;
+    [[nodiscard]] auto parseInitDeclarator(st::NodeList<st::DeclarationSpecifier> declspecs)
+        -> Declaration;
+    [[nodiscard]] auto parseFunctionDefinition() -> ExternalDeclaration;
+    auto skipFunctionDefinition() -> void;
+    [[nodiscard]] auto parseExternalDeclaration() -> std::optional<ExternalDeclaration>;
+    [[nodiscard]] auto parsePostfixExpression() -> Expression;
+    [[nodiscard]] auto parseUnaryExpression() -> Expression;
+    [[nodiscard]] auto parseBinaryExpression(std::uint8_t min_power) -> Expression;
+    [[nodiscard]] auto parseForStatement() -> Statement;
+
+    // Lists are built on a stack per element type and handed on once complete, so a list nested
+    // in another (a call in an argument, a block in a block) cannot split it.
+    template <typename T>
+    [[nodiscard]] auto pending() -> std::vector<T>& {
+        return std::get<std::vector<T>>(pending_lists);
+    }
+    // passes the entries from `begin` up of the stack for T to `build`, then pops them
+    template <typename T, typename F>
+    [[nodiscard]] auto finish_list(std::size_t begin, F&& build);
+    // moves the entries from `begin` up of the stack for T into builder.syntax_tree()
+    template <typename T>
+    [[nodiscard]] auto finish_list(std::size_t begin) -> st::NodeList<T>;
+
+    TokenStream stream;
+    std::string_view source;
+    Builder builder;
+    std::tuple<std::vector<Expression>, std::vector<BlockItem>,
+               std::vector<st::DeclarationSpecifier>, std::vector<st::ParameterDeclaration>>
+        pending_lists;
+};
+
+using Parser = BasicParser<st::TreeBuilder>;
+
+// `source` is the buffer the tokens point into
+[[nodiscard]] auto parse(const std::vector<Token>& tokens, std::string_view source)
+    -> st::Program;
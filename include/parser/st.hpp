@@ -1,74 +1,78 @@
 #pragma once
 
 #include <cassert>
+#include <cstdint>
 #include <iostream>
-#include <memory>
+#include <limits>
 #include <optional>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <variant>
 #include <vector>
 
+// The syntax tree of a translation unit. Nodes live in one pool per node type inside a Tree and
+// refer to each other by 32 bit index; lists are runs of consecutive entries of a pool. Names
+// are views into the source buffer, which has to outlive the tree. Nothing in a pool owns
+// memory, so dropping a tree frees a fixed number of buffers however large the program is.
 namespace st {
 
-class PrimaryExpression;
-class AssignmentExpression;
-class UnaryExpression;
-class AdditiveExpression;
-class FunctionCallExpression;
-class ArrayAccessExpression;
-class MultiplicativeExpression;
+using NodeIndex = std::uint32_t;
 
-using Expression =
-    std::variant<std::shared_ptr<PrimaryExpression>, std::shared_ptr<AssignmentExpression>,
-                 std::shared_ptr<UnaryExpression>, std::shared_ptr<AdditiveExpression>,
-                 std::shared_ptr<FunctionCallExpression>, std::shared_ptr<ArrayAccessExpression>,
-                 std::shared_ptr<MultiplicativeExpression>>;
+// `count` consecutive entries of the pool of T, starting at `first`
+template <typename T>
+struct NodeList {
+    NodeIndex first = 0;
+    NodeIndex count = 0;
+};
+
+enum class ExpressionKind : std::uint8_t {
+    PRIMARY,
+    ASSIGNMENT,
+    UNARY,
+    ADDITIVE,
+    FUNCTION_CALL,
+    ARRAY_ACCESS,
+    MULTIPLICATIVE,
+};
 
-inline std::ostream& operator<<(std::ostream& os, const Expression& node);
+// an expression node, `index` is its position in the pool for `kind`
+struct Expression {
+    ExpressionKind kind = ExpressionKind::PRIMARY;
+    NodeIndex index = 0;
+};
 
 enum class PrimaryExpressionType { INT, FLOAT, IDEN };
 
 class PrimaryExpression {
    public:
-    PrimaryExpression(int p_value)
-        : type(PrimaryExpressionType::INT), value(p_value), f_value(0.0), idenValue("") {}
+    static constexpr auto kind = ExpressionKind::PRIMARY;
 
-    PrimaryExpression(float p_value)
-        : type(PrimaryExpressionType::FLOAT), value(0), f_value(p_value), idenValue("") {}
+    explicit PrimaryExpression(int p_value) : type(PrimaryExpressionType::INT), value(p_value) {}
 
-    PrimaryExpression(std::string p_iden_value)
-        : type(PrimaryExpressionType::IDEN), value(0), f_value(0.0), idenValue(p_iden_value) {}
+    explicit PrimaryExpression(float p_value)
+        : type(PrimaryExpressionType::FLOAT), f_value(p_value) {}
 
-    std::ostream& print(std::ostream& os) {
-        if (type == PrimaryExpressionType::INT) {
-            os << "PrimaryExpression(type=INT, value=" << value << ")";
-        } else {
-            os << "PrimaryExpression(type=IDEN, idenValue=" << idenValue << ")";
-        }
-        return os;
-    }
+    explicit PrimaryExpression(std::string_view p_iden_value)
+        : type(PrimaryExpressionType::IDEN), idenValue(p_iden_value) {}
 
     PrimaryExpressionType type;
-    int value;
+    int value = 0;
 
-    float f_value;
-    std::string idenValue;
+    float f_value = 0.0;
+    std::string_view idenValue = "";
 };
 
 enum class MultiplicativeExpressionType { Mult, Div };
 
 class MultiplicativeExpression {
    public:
-    MultiplicativeExpression(Expression lhs, Expression rhs, MultiplicativeExpressionType type);
+    static constexpr auto kind = ExpressionKind::MULTIPLICATIVE;
 
-    std::ostream& print(std::ostream& os) {
-        os << "MultiplicativeExpression(lhs=";
-        os << lhs;
-        os << ", rhs=";
-        os << rhs;
-        os << ")";
-        return os;
-    }
+    MultiplicativeExpression(Expression lhs, Expression rhs, MultiplicativeExpressionType type);
 
     Expression lhs;
     Expression rhs;
@@ -79,16 +83,9 @@ enum class AdditiveExpressionType { ADD, SUB, GT, EQ, NEQ, LT };
 
 class AdditiveExpression {
    public:
-    AdditiveExpression(Expression lhs, Expression rhs, AdditiveExpressionType type);
+    static constexpr auto kind = ExpressionKind::ADDITIVE;
 
-    std::ostream& print(std::ostream& os) {
-        os << "AdditiveExpression(lhs=";
-        os << lhs;
-        os << ", rhs=";
-        os << rhs;
-        os << ")";
-        return os;
-    }
+    AdditiveExpression(Expression lhs, Expression rhs, AdditiveExpressionType type);
 
     Expression lhs;
     Expression rhs;
@@ -97,16 +94,9 @@ class AdditiveExpression {
 
 class AssignmentExpression {
    public:
-    AssignmentExpression(Expression p_lhs, Expression p_rhs);
+    static constexpr auto kind = ExpressionKind::ASSIGNMENT;
 
-    std::ostream& print(std::ostream& os) {
-        os << "AssignmentExpression(lhs=";
-        os << lhs;
-        os << ", rhs=";
-        os << rhs;
-        os << ")";
-        return os;
-    }
+    AssignmentExpression(Expression p_lhs, Expression p_rhs);
 
     Expression lhs;
     Expression rhs;
@@ -116,68 +106,40 @@ enum class UnaryExpressionType { DEREF, ADDR, NEG };
 
 class UnaryExpression {
    public:
-    UnaryExpression(UnaryExpressionType type, Expression p_expr);
+    static constexpr auto kind = ExpressionKind::UNARY;
 
-    std::ostream& print(std::ostream& os) {
-        os << "UnaryExpression(type=";
-        if (type == UnaryExpressionType::DEREF) {
-            os << "DEREF";
-        } else {
-            os << "ADDR";
-        }
-        os << ", expr=";
-        os << expr;
-        os << ")";
-        return os;
-    }
+    UnaryExpression(UnaryExpressionType type, Expression p_expr);
 
     UnaryExpressionType type;
     Expression expr;
 };
 
-inline std::ostream& operator<<(std::ostream& os, const Expression& expr) {
-    if (std::holds_alternative<std::shared_ptr<PrimaryExpression>>(expr)) {
-        return std::get<std::shared_ptr<PrimaryExpression>>(expr)->print(os);
-    }
-    if (std::holds_alternative<std::shared_ptr<AssignmentExpression>>(expr)) {
-        std::get<std::shared_ptr<AssignmentExpression>>(expr).get()->print(os);
-    }
-    if (std::holds_alternative<std::shared_ptr<UnaryExpression>>(expr)) {
-        std::get<std::shared_ptr<UnaryExpression>>(expr).get()->print(os);
-    }
-    if (std::holds_alternative<std::shared_ptr<AdditiveExpression>>(expr)) {
-        std::get<std::shared_ptr<AdditiveExpression>>(expr).get()->print(os);
-    }
-    return os;
-}
-
 class FunctionCallExpression {
    public:
-    explicit FunctionCallExpression(std::string p_name, std::vector<Expression> p_args);
+    static constexpr auto kind = ExpressionKind::FUNCTION_CALL;
+
+    explicit FunctionCallExpression(std::string_view p_name, NodeList<Expression> p_args);
 
-    std::string name;
-    std::vector<Expression> args;
+    std::string_view name;
+    NodeList<Expression> args;
 };
 
 class ArrayAccessExpression {
    public:
-    explicit ArrayAccessExpression(std::string p_name, Expression p_index);
+    static constexpr auto kind = ExpressionKind::ARRAY_ACCESS;
 
-    std::string name;
+    explicit ArrayAccessExpression(std::string_view p_name, Expression p_index);
+
+    std::string_view name;
     Expression index;
 };
 
 class Initalizer {
    public:
-    explicit Initalizer(Expression p_expr) : expr(std::move(p_expr)) {}
+    explicit Initalizer(Expression p_expr) : expr(p_expr) {}
     Expression expr;
 };
 
-inline std::ostream& operator<<(std::ostream& os, const Initalizer& node) {
-    os << "Initalizer(expr=" << node.expr << ")";
-    return os;
-}
-
 class Pointer {
    public:
     size_t level;
@@ -201,7 +163,7 @@ class TypeSpecifier {
    public:
     enum class Type { INT, DOUBLE, IDEN, FLOAT };
     Type type;
-    std::string iden;
+    std::string_view iden;
 };
 
 inline std::ostream& operator<<(std::ostream& os, const TypeSpecifier& node) {
@@ -221,14 +183,14 @@ inline std::ostream& operator<<(std::ostream& os, const DeclarationSpecifier& no
 
 class VariableDirectDeclarator {
    public:
-    std::string name = "";
+    std::string_view name = "";
 };
 
 class ParameterDeclaration;
 
 class ParamTypeList {
    public:
-    std::vector<ParameterDeclaration> params;
+    NodeList<ParameterDeclaration> params;
     bool va_args;
 };
 
@@ -240,7 +202,7 @@ class FunctionDirectDeclarator {
 
 class ArrayDirectDeclarator {
    public:
-    std::string name;
+    std::string_view name;
     Expression size;
 };
 
@@ -254,10 +216,10 @@ class DirectDeclarator {
 
     std::string VariableIden() const {
         if (kind == DeclaratorKind::VARIABLE) {
-            return std::get<VariableDirectDeclarator>(declarator).name;
+            return std::string(std::get<VariableDirectDeclarator>(declarator).name);
         }
         if (kind == DeclaratorKind::ARRAY) {
-            return std::get<ArrayDirectDeclarator>(declarator).name;
+            return std::string(std::get<ArrayDirectDeclarator>(declarator).name);
         }
 
         throw std::runtime_error("Not a variable");
@@ -292,12 +254,13 @@ class ParameterDeclaration {
    public:
     [[nodiscard]] std::string Name() const {
         if (declarator.directDeclarator.kind == DeclaratorKind::VARIABLE) {
-            return std::get<VariableDirectDeclarator>(declarator.directDeclarator.declarator).name;
+            return std::string(
+                std::get<VariableDirectDeclarator>(declarator.directDeclarator.declarator).name);
         }
         throw std::runtime_error("Not a variable");
     }
 
-    std::vector<DeclarationSpecifier> declarationSpecifiers;
+    NodeList<DeclarationSpecifier> declarationSpecifiers;
     Declarator declarator;
 
     Declarator GetDeclarator() const { return declarator; }
@@ -320,20 +283,9 @@ class InitDeclarator {
     std::optional<Initalizer> initializer;
 };
 
-inline std::ostream& operator<<(std::ostream& os, const InitDeclarator& node) {
-    os << "InitDeclarator(declarator=" << node.declarator << ", initializer=";
-    if (node.initializer) {
-        os << *node.initializer;
-    } else {
-        os << "nullptr";
-    }
-    os << ")";
-    return os;
-}
-
 class Declaration {
    public:
-    std::vector<DeclarationSpecifier> declarationSpecifiers;
+    NodeList<DeclarationSpecifier> declarationSpecifiers;
     std::optional<InitDeclarator> initDeclarator;
 
     std::optional<Declarator> GetDeclarator() const {
@@ -344,78 +296,45 @@ class Declaration {
     }
 };
 
-inline std::ostream& operator<<(std::ostream& os, const Declaration& node) {
-    os << "Declaration(declarationSpecifiers=[";
-    for (auto& v : node.declarationSpecifiers) {
-        os << v << ",";
-    }
-    os << "], initDeclarator=";
-    if (node.initDeclarator) {
-        os << *node.initDeclarator;
-    } else {
-        os << "nullptr";
-    }
-    os << ")";
-    return os;
-}
+enum class StatementKind : std::uint8_t { EXPRESSION, RETURN, SELECTION, FOR };
+
+// a statement node, `index` is its position in the pool for `kind`
+struct Statement {
+    StatementKind kind = StatementKind::EXPRESSION;
+    NodeIndex index = 0;
+};
 
 class ExpressionStatement {
    public:
-    explicit ExpressionStatement(Expression p_expr) : expr(std::move(p_expr)) {}
+    static constexpr auto kind = StatementKind::EXPRESSION;
 
-    std::ostream& print(std::ostream& os) const {
-        os << "ExpressionStatement(expr=";
-        os << expr;
-        os << ")";
-        return os;
-    }
+    explicit ExpressionStatement(Expression p_expr) : expr(p_expr) {}
 
     Expression expr;
 };
 
-struct CompoundStatement;
+class BlockItem;
+
+struct CompoundStatement {
+    NodeList<BlockItem> items;
+};
 
 class SelectionStatement {
    public:
-    explicit SelectionStatement(Expression p_cond, std::shared_ptr<CompoundStatement> p_then,
-                                std::shared_ptr<CompoundStatement> p_else);
-
-    std::ostream& print(std::ostream& os) const {
-        os << "SelectionStatement(cond=";
-        os << cond;
-        os << ", then=";
-        os << then;
-        os << ", else=";
-        os << else_;
-        os << ")";
-        return os;
-    }
+    static constexpr auto kind = StatementKind::SELECTION;
+
+    explicit SelectionStatement(Expression p_cond, CompoundStatement p_then,
+                                std::optional<CompoundStatement> p_else);
 
     Expression cond;
-    std::shared_ptr<CompoundStatement> then;
-    std::shared_ptr<CompoundStatement> else_;
+    CompoundStatement then;
+    std::optional<CompoundStatement> else_;
 };
 
 struct ForDeclaration {
-    explicit ForDeclaration(std::vector<DeclarationSpecifier> p_declarationSpecifiers,
-                            InitDeclarator p_initDeclarator)
-        : declarationSpecifiers(std::move(p_declarationSpecifiers)),
-          initDeclarator(std::move(p_initDeclarator)) {}
-
-    std::ostream& print(std::ostream& os) const {
-        os << "ForDeclaration(declarationSpecifiers=[";
-        for (auto& v : declarationSpecifiers) {
-            os << v << ",";
-        }
-        os << "], initDeclarator=";
-        if (initDeclarator) {
-            os << *initDeclarator;
-        } else {
-            os << "nullptr";
-        }
-        os << ")";
-        return os;
-    }
+    explicit ForDeclaration(NodeList<DeclarationSpecifier> p_declarationSpecifiers,
+                            std::optional<InitDeclarator> p_initDeclarator)
+        : declarationSpecifiers(p_declarationSpecifiers), initDeclarator(p_initDeclarator) {}
 
     [[nodiscard]] std::optional<Declarator> GetDeclarator() const {
         if (initDeclarator) {
@@ -424,76 +343,32 @@ struct ForDeclaration {
         return std::nullopt;
     }
 
-    std::vector<DeclarationSpecifier> declarationSpecifiers = {};
+    NodeList<DeclarationSpecifier> declarationSpecifiers = {};
     std::optional<InitDeclarator> initDeclarator = std::nullopt;
 };
 
 class ReturnStatement {
    public:
-    explicit ReturnStatement(Expression p_expr) : expr(std::move(p_expr)) {}
-
-    std::ostream& print(std::ostream& os) const {
-        os << "ReturnStatement(expr=";
-        os << expr;
-        os << ")";
-        return os;
-    }
-    Expression expr;
-};
-
-class ForStatement;
-
-class Statement {
-   public:
-    explicit Statement(
-        std::variant<std::shared_ptr<ExpressionStatement>, std::shared_ptr<ReturnStatement>,
-                     std::shared_ptr<SelectionStatement>, std::shared_ptr<ForStatement>>
-            p_stmt);
-
-    explicit Statement(std::shared_ptr<ExpressionStatement> node);
+    static constexpr auto kind = StatementKind::RETURN;
 
-    explicit Statement(std::shared_ptr<ReturnStatement> node);
+    explicit ReturnStatement(Expression p_expr) : expr(p_expr) {}
 
-    explicit Statement(std::shared_ptr<SelectionStatement> node);
-
-    std::variant<std::shared_ptr<ExpressionStatement>, std::shared_ptr<ReturnStatement>,
-                 std::shared_ptr<SelectionStatement>, std::shared_ptr<ForStatement>>
-        stmt;
+    Expression expr;
 };
 
 class ForStatement {
    public:
-    explicit ForStatement(ForDeclaration init, std::optional<Expression> cond,
-                          std::optional<Expression> inc, std::shared_ptr<CompoundStatement> body);
+    static constexpr auto kind = StatementKind::FOR;
 
-    std::ostream& print(std::ostream& os) const;
+    explicit ForStatement(ForDeclaration init, std::optional<Expression> cond,
+                          std::optional<Expression> inc, CompoundStatement body);
 
     ForDeclaration init;
     std::optional<Expression> cond;
     std::optional<Expression> inc;
-    std::shared_ptr<CompoundStatement> body;
+    CompoundStatement body;
 };
 
-inline std::ostream& operator<<(std::ostream& os, const Statement& node) {
-    if (std::holds_alternative<std::shared_ptr<ExpressionStatement>>(node.stmt)) {
-        os << "Statement(";
-        return std::get<std::shared_ptr<ExpressionStatement>>(node.stmt)->print(os) << "))";
-    }
-    if (std::holds_alternative<std::shared_ptr<SelectionStatement>>(node.stmt)) {
-        os << "Statement(";
-        return std::get<std::shared_ptr<SelectionStatement>>(node.stmt)->print(os) << "))";
-    }
-    if (std::holds_alternative<std::shared_ptr<ForStatement>>(node.stmt)) {
-        os << "Statement(";
-        return std::get<std::shared_ptr<ForStatement>>(node.stmt)->print(os) << "))";
-    }
-    if (std::holds_alternative<std::shared_ptr<ReturnStatement>>(node.stmt)) {
-        os << "Statement(";
-        return std::get<std::shared_ptr<ReturnStatement>>(node.stmt)->print(os) << "))";
-    }
-    throw std::runtime_error("Not implemented");
-}
-
 class BlockItem {
    public:
     explicit BlockItem(std::variant<Declaration, Statement> item);
@@ -504,52 +379,19 @@ class BlockItem {
     std::variant<Declaration, Statement> item;
 };
 
-struct CompoundStatement {
-    std::vector<BlockItem> items;
-
-    std::ostream& print(std::ostream& os) const {
-        os << "CompoundStatement(items=[";
-        for (auto& v : items) {
-            if (std::holds_alternative<Declaration>(v.item)) {
-                os << std::get<Declaration>(v.item) << std::endl;
-            } else {
-                const auto& stmt = std::get<Statement>(v.item);
-                os << stmt << std::endl;
-            }
-            os << "\n";
-        }
-        os << "])";
-        return os;
-    }
-};
-
-inline std::ostream& operator<<(std::ostream& os, const CompoundStatement& node) {
-    os << "CompoundStatement(items=[";
-    for (auto& v : node.items) {
-        if (std::holds_alternative<Declaration>(v.item)) {
-            os << std::get<Declaration>(v.item) << std::endl;
-        } else {
-            const auto& stmt = std::get<Statement>(v.item);
-            os << stmt << std::endl;
-        }
-        os << "\n";
-    }
-    os << "])";
-    return os;
-}
-
 class FuncDef {
    public:
-    FuncDef(std::vector<DeclarationSpecifier> p_declarationSpecifiers, Declarator p_declarator,
+    FuncDef(NodeList<DeclarationSpecifier> p_declarationSpecifiers, Declarator p_declarator,
             CompoundStatement p_body)
-        : declarationSpecifiers(std::move(p_declarationSpecifiers)),
-          declarator(std::move(p_declarator)),
-          body(std::move(p_body)) {}
+        : declarationSpecifiers(p_declarationSpecifiers),
+          declarator(p_declarator),
+          body(p_body) {}
 
     std::string Name() const {
         if (declarator.directDeclarator.kind == DeclaratorKind::FUNCTION) {
-            return std::get<FunctionDirectDeclarator>(declarator.directDeclarator.declarator)
-                .declarator.name;
+            return std::string(
+                std::get<FunctionDirectDeclarator>(declarator.directDeclarator.declarator)
+                    .declarator.name);
         }
         throw std::runtime_error("Not a function");
     }
@@ -559,53 +401,159 @@ class FuncDef {
         return std::get<FunctionDirectDeclarator>(declarator.directDeclarator.declarator);
     }
 
-    std::vector<DeclarationSpecifier> declarationSpecifiers;
+    NodeList<DeclarationSpecifier> declarationSpecifiers;
     Declarator declarator;
     CompoundStatement body;
 };
 
 struct ExternalDeclaration {
-    explicit ExternalDeclaration(std::variant<Declaration, std::shared_ptr<FuncDef>> p_node)
-        : node(std::move(p_node)) {}
+    explicit ExternalDeclaration(std::variant<Declaration, FuncDef> p_node) : node(p_node) {}
 
     explicit ExternalDeclaration(Declaration p_node)
-        : node(std::variant<Declaration, std::shared_ptr<FuncDef>>(std::move(p_node))) {}
+        : node(std::variant<Declaration, FuncDef>(p_node)) {}
 
-    explicit ExternalDeclaration(std::shared_ptr<FuncDef> p_node)
-        : node(std::variant<Declaration, std::shared_ptr<FuncDef>>(std::move(p_node))) {}
+    explicit ExternalDeclaration(FuncDef p_node)
+        : node(std::variant<Declaration, FuncDef>(p_node)) {}
 
    public:
-    std::variant<Declaration, std::shared_ptr<FuncDef>> node;
+    std::variant<Declaration, FuncDef> node;
 };
 
-inline std::ostream& operator<<(std::ostream& os, const ExternalDeclaration& node) {
-    if (std::holds_alternative<Declaration>(node.node)) {
-        const auto& decl = std::get<Declaration>(node.node);
-        os << "ExternalDeclaration(Declaration(declarationSpecifiers=[";
-        for (auto& v : decl.declarationSpecifiers) {
-            os << v << ",";
+// Owns every node of a syntax tree. Adding to a pool may move it, so hold indices rather than
+// references across calls to add().
+class Tree {
+   public:
+    // appends `node` to the pool for its type and returns its index
+    template <typename T>
+    auto add(const T& node) -> NodeIndex {
+        auto& nodes = pool<T>();
+        if (nodes.size() > std::numeric_limits<NodeIndex>::max()) {
+            throw std::runtime_error("Too many syntax tree nodes");
         }
-        os << "], initDeclarator=";
-        if (decl.initDeclarator) {
-            os << *decl.initDeclarator;
-        } else {
-            os << "nullptr";
+        nodes.push_back(node);
+        return static_cast<NodeIndex>(nodes.size() - 1);
+    }
+
+    template <typename T>
+    auto add_expression(const T& node) -> Expression {
+        return Expression{.kind = T::kind, .index = add(node)};
+    }
+
+    template <typename T>
+    auto add_statement(const T& node) -> Statement {
+        return Statement{.kind = T::kind, .index = add(node)};
+    }
+
+    // copies `items` to the end of their pool, keeping them consecutive
+    template <typename T>
+    auto add_list(std::span<const T> items) -> NodeList<T> {
+        auto& nodes = pool<T>();
+        if (nodes.size() + items.size() > std::numeric_limits<NodeIndex>::max()) {
+            throw std::runtime_error("Too many syntax tree nodes");
         }
-    } else {
-        const auto& funcdef = std::get<std::shared_ptr<FuncDef>>(node.node);
-        os << "ExternalDeclaration(FuncDef(declarationSpecifiers=[";
-        for (auto& v : funcdef->declarationSpecifiers) {
-            os << v << ",";
+        const auto first = static_cast<NodeIndex>(nodes.size());
+        nodes.insert(nodes.end(), items.begin(), items.end());
+        return NodeList<T>{.first = first, .count = static_cast<NodeIndex>(items.size())};
+    }
+
+    template <typename T>
+    [[nodiscard]] auto get(NodeIndex index) const -> const T& {
+        return pool<T>()[index];
+    }
+
+    template <typename T>
+    [[nodiscard]] auto get(Expression expr) const -> const T& {
+        assert(expr.kind == T::kind);
+        return get<T>(expr.index);
+    }
+
+    template <typename T>
+    [[nodiscard]] auto get(Statement stmt) const -> const T& {
+        assert(stmt.kind == T::kind);
+        return get<T>(stmt.index);
+    }
+
+    template <typename T>
+    [[nodiscard]] auto list(NodeList<T> nodes) const -> std::span<const T> {
+        return std::span<const T>(pool<T>()).subspan(nodes.first, nodes.count);
+    }
+
+    // calls `f` with the node `expr` refers to
+    template <typename F>
+    auto visit(F&& f, Expression expr) const -> decltype(auto) {
+        switch (expr.kind) {
+            case ExpressionKind::PRIMARY:
+                return f(get<PrimaryExpression>(expr.index));
+            case ExpressionKind::ASSIGNMENT:
+                return f(get<AssignmentExpression>(expr.index));
+            case ExpressionKind::UNARY:
+                return f(get<UnaryExpression>(expr.index));
+            case ExpressionKind::ADDITIVE:
+                return f(get<AdditiveExpression>(expr.index));
+            case ExpressionKind::FUNCTION_CALL:
+                return f(get<FunctionCallExpression>(expr.index));
+            case ExpressionKind::ARRAY_ACCESS:
+                return f(get<ArrayAccessExpression>(expr.index));
+            case ExpressionKind::MULTIPLICATIVE:
+                return f(get<MultiplicativeExpression>(expr.index));
         }
-        os << "]\n, declarator=" << funcdef->declarator << "\n, body=" << funcdef->body;
+        throw std::logic_error("unknown expression kind");
+    }
+
+    // calls `f` with the node `stmt` refers to
+    template <typename F>
+    auto visit(F&& f, Statement stmt) const -> decltype(auto) {
+        switch (stmt.kind) {
+            case StatementKind::EXPRESSION:
+                return f(get<ExpressionStatement>(stmt.index));
+            case StatementKind::RETURN:
+                return f(get<ReturnStatement>(stmt.index));
+            case StatementKind::SELECTION:
+                return f(get<SelectionStatement>(stmt.index));
+            case StatementKind::FOR:
+                return f(get<ForStatement>(stmt.index));
+        }
+        throw std::logic_error("unknown statement kind");
+    }
+
+   private:
+    template <typename T>
+    [[nodiscard]] auto pool() -> std::vector<T>& {
+        static_assert(std::is_trivially_destructible_v<T>, "the tree is freed without a walk");
+        return std::get<std::vector<T>>(pools);
     }
-    return os;
-}
+
+    template <typename T>
+    [[nodiscard]] auto pool() const -> const std::vector<T>& {
+        return std::get<std::vector<T>>(pools);
+    }
+
+    std::tuple<std::vector<PrimaryExpression>, std::vector<AssignmentExpression>,
+               std::vector<UnaryExpression>, std::vector<AdditiveExpression>,
+               std::vector<FunctionCallExpression>, std::vector<ArrayAccessExpression>,
+               std::vector<MultiplicativeExpression>, std::vector<ExpressionStatement>,
+               std::vector<ReturnStatement>, std::vector<SelectionStatement>,
+               std::vector<ForStatement>, std::vector<Expression>, std::vector<BlockItem>,
+               std::vector<DeclarationSpecifier>, std::vector<ParameterDeclaration>>
+        pools = {};
+};
 
 class Program {
    public:
-    explicit Program(std::vector<ExternalDeclaration> p_nodes) : nodes(std::move(p_nodes)) {}
+    Program(Tree p_tree, std::vector<ExternalDeclaration> p_nodes)
+        : tree(std::move(p_tree)), nodes(std::move(p_nodes)) {}
+    Tree tree;
     std::vector<ExternalDeclaration> nodes;
 };
 
-}  // namespace st
\ No newline at end of file
+// debug printing for --dump=st, nodes are looked up in `tree`
+auto print(std::ostream& os, const Tree& tree, Expression expr) -> std::ostream&;
+auto print(std::ostream& os, const Tree& tree, Statement stmt) -> std::ostream&;
+auto print(std::ostream& os, const Tree& tree, const CompoundStatement& node) -> std::ostream&;
+auto print(std::ostream& os, const Tree& tree, const Declaration& node) -> std::ostream&;
+auto print(std::ostream& os, const Tree& tree, const ExternalDeclaration& node) -> std::ostream&;
+
+// number of syntax tree nodes reachable from the program, for the time report
+[[nodiscard]] auto count_nodes(const Program& program) -> std::size_t;
+
+}  // namespace st
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "../lexer/lexer.hpp"
+#include "../lexer/token.hpp"
+
+// The parser's view of the tokens. Either walks tokens that were lexed up front, or pulls them
+// from a lexer as the parser asks for them. When streaming, only the tokens from the previous
+// one up to the parser's furthest lookahead are kept, in a ring that grows to the longest
+// lookahead seen, so memory does not grow with the file and lexing overlaps parsing.
+class TokenStream {
+   public:
+    // `p_tokens` must end with TOKEN_FEOF and outlive the stream
+    explicit TokenStream(std::span<const Token> p_tokens);
+    // streams the tokens of `source`; lexer errors surface from peek() and advance()
+    explicit TokenStream(std::string_view source);
+
+    // The token `n` ahead of the current one, TOKEN_FEOF past the end. When streaming, the
+    // reference is only good until the stream looks further ahead than it did before; copy the
+    // token to keep it longer.
+    [[nodiscard]] auto peek(std::size_t n = 0) -> const Token& {
+        const auto index = current + n;
+        if (!lexer.has_value()) {
+            return index < tokens.size() ? tokens[index] : end_of_input;
+        }
+        if (index >= end) {
+            fill(index);
+        }
+        return at(index);
+    }
+    // the current token, moving past it unless it is the end of the input
+    auto advance() -> Token;
+    // the token before the current one; only valid after an advance(), and for as long as peek()
+    [[nodiscard]] auto previous() const -> const Token&;
+
+    // how many tokens were consumed so far
+    [[nodiscard]] auto position() const -> std::size_t { return current; }
+    // continues at token `position`; only for tokens that were lexed up front
+    void seek(std::size_t position);
+    // the most tokens held at once, 0 when not streaming
+    [[nodiscard]] auto buffered_peak() const -> std::size_t { return peak; }
+
+   private:
+    static constexpr Token end_of_input = {};
+
+    [[nodiscard]] auto at(std::size_t index) const -> const Token& {
+        return ring[index & (ring.size() - 1)];
+    }
+    void fill(std::size_t index);
+    void grow();
+
+    std::span<const Token> tokens = {};
+    std::optional<lexer::Lexer> lexer = std::nullopt;
+    // indices are positions in the whole token sequence; ring holds [first, end)
+    std::vector<Token> ring = {};
+    std::size_t first = 0;
+    std::size_t end = 0;
+    std::size_t current = 0;
+    std::size_t peak = 0;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "operators.hpp"
+#include "st.hpp"
+
+namespace st {
+
+// The builder behind Parser: keeps the program as written, for --dump=st and ast::translate().
+// See BasicParser for what the parser expects of a builder.
+class TreeBuilder {
+   public:
+    using Expression = st::Expression;
+    using Statement = st::Statement;
+    using BlockItem = st::BlockItem;
+    using CompoundStatement = st::CompoundStatement;
+    using Declaration = st::Declaration;
+    using ExternalDeclaration = st::ExternalDeclaration;
+    using Program = st::Program;
+
+    [[nodiscard]] auto syntax_tree() -> Tree& { return tree; }
+
+    [[nodiscard]] auto primary(PrimaryExpression expr) -> Expression {
+        return tree.add_expression(expr);
+    }
+    [[nodiscard]] auto callee_name(Expression callee) const -> std::string_view;
+    [[nodiscard]] auto call(std::string_view name, std::span<Expression> args) -> Expression;
+    [[nodiscard]] auto array_access(std::string_view name, Expression index) -> Expression;
+    [[nodiscard]] auto unary(UnaryExpressionType type, Expression operand) -> Expression;
+    auto begin_right_operand(BinaryOp, Expression&) -> void {}
+    [[nodiscard]] auto binary(BinaryOp op, Expression lhs, Expression rhs) -> Expression;
+    [[nodiscard]] auto array_size(Expression size) -> Expression { return size; }
+
+    auto begin_return() -> void {}
+    [[nodiscard]] auto return_statement(Expression expr) -> Statement;
+    [[nodiscard]] auto expression_statement(Expression expr) -> Statement;
+    [[nodiscard]] auto if_statement(Expression cond, CompoundStatement then,
+                                    std::optional<CompoundStatement> else_) -> Statement;
+    [[nodiscard]] auto for_statement(const Declaration& init, std::optional<Expression> cond,
+                                     std::optional<Expression> inc, CompoundStatement body)
+        -> Statement;
+    [[nodiscard]] auto block(std::span<BlockItem> items) -> CompoundStatement;
+
+    [[nodiscard]] auto declare(NodeList<DeclarationSpecifier> specifiers,
+                               const Declarator& declarator) -> Declaration;
+    auto begin_initializer() -> void {}
+    [[nodiscard]] auto declaration(Declaration declared, std::optional<Expression> initializer)
+        -> Declaration;
+
+    [[nodiscard]] auto begin_function(NodeList<DeclarationSpecifier> specifiers,
+                                      const Declarator& declarator) -> FuncDef;
+    [[nodiscard]] auto function(FuncDef fd, CompoundStatement body) -> ExternalDeclaration;
+    [[nodiscard]] auto external(Declaration decl) -> ExternalDeclaration;
+    [[nodiscard]] auto program(std::vector<ExternalDeclaration> nodes) -> Program;
+
+   private:
+    Tree tree = {};
+};
+
+}  // namespace st
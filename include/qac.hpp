@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "support/time_report.hpp"
+
+namespace support {
+class ThreadPool;
+}  // namespace support
+
+// In-process compile API of the qac_core library. Nothing touches the file system, so a host
+// can compile many sources without spawning processes or writing temporary files.
+namespace qac {
+
+struct Options {
+    // name used for the source in diagnostics
+    std::string source_name = "<source>";
+    // threads the functions of the source are compiled on, unless a pool is given
+    unsigned jobs = 1;
+    // fill CompileResult::phases
+    bool time_report = false;
+    // see DriverOptions
+    bool fused_front_end = false;
+    bool parallel_front_end = false;
+};
+
+struct CompileResult {
+    bool ok = false;
+    // nasm assembly, empty when compilation failed
+    std::string assembly = "";
+    // the messages qac would print to stderr, one per line
+    std::string diagnostics = "";
+    std::vector<support::PhaseRecord> phases = {};
+};
+
+[[nodiscard]] auto compile(std::string_view source, const Options& options = {}) -> CompileResult;
+// The same on a pool shared with other compiles, options.jobs is not used.
+[[nodiscard]] auto compile(std::string_view source, const Options& options,
+                           support::ThreadPool& pool) -> CompileResult;
+
+}  // namespace qac
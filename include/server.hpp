@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+
+#include "driver.hpp"
+
+// A resident compiler, `qac --server <socket>`, and the client side used by
+// `qac --connect=<socket>`. Requests and replies are sequences of length prefixed strings on a
+// Unix domain socket:
+//   request: source name, source text, then "0" or "1" for the time report, the fused and the
+//            parallel front end
+//   reply:   exit status, assembly, diagnostics
+// Options that only change where output goes or what is kept on disk are refused by the client.
+namespace server {
+
+// Serves compile requests on `socket_path` until the process is terminated, `threads`
+// connections at a time. Every compile runs its functions on one pool of `threads` shared by all
+// connections, whatever -j the client was given. A socket file already at `socket_path` is only
+// replaced when no server listens on it. Connections that stall are dropped. Only returns when
+// the socket cannot be set up.
+[[nodiscard]] int serve(const std::string& socket_path, unsigned threads);
+
+// Compiles `sourcefile` on the server listening at `socket_path`, writes the assembly to
+// `outfile` and prints the diagnostics, returning the status a local runfile() would have.
+[[nodiscard]] int compile_remote(const std::string& socket_path, const char* sourcefile,
+                                 const std::string& outfile, const DriverOptions& options);
+
+}  // namespace server
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace support {
+
+// Incremental SHA-256 (FIPS 180-4), used to key on-disk caches.
+class Sha256 {
+   public:
+    Sha256();
+
+    void update(std::string_view data);
+    // a length prefixed field, so ("ab", "c") and ("a", "bc") hash differently
+    void update_field(std::string_view field);
+    // lower case hex digest; the hasher must not be updated afterwards
+    [[nodiscard]] auto hex_digest() -> std::string;
+
+   private:
+    void compress(const unsigned char* block);
+
+    std::array<std::uint32_t, 8> state = {};
+    std::array<unsigned char, 64> buffer = {};
+    std::size_t buffered = 0;
+    std::uint64_t total_bytes = 0;
+};
+
+}  // namespace support
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace support {
+
+// The contents of a source file. Regular files are mapped read-only and never copied; stdin
+// ("-"), pipes and other files that cannot be mapped are read once into an owned string.
+class SourceBuffer {
+   public:
+    // throws std::runtime_error when the file cannot be opened or read
+    [[nodiscard]] static auto open(const char* path) -> SourceBuffer;
+
+    SourceBuffer(SourceBuffer&& other) noexcept;
+    auto operator=(SourceBuffer&& other) noexcept -> SourceBuffer&;
+    SourceBuffer(const SourceBuffer&) = delete;
+    auto operator=(const SourceBuffer&) -> SourceBuffer& = delete;
+    ~SourceBuffer();
+
+    [[nodiscard]] auto view() const -> std::string_view {
+        return mapping != nullptr ? std::string_view(static_cast<const char*>(mapping), size)
+                                  : std::string_view(owned);
+    }
+
+   private:
+    SourceBuffer() = default;
+
+    void* mapping = nullptr;
+    std::size_t size = 0;
+    std::string owned = "";
+};
+
+}  // namespace support
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace support {
+
+class ThreadPool {
+   public:
+    // `threads` includes the thread calling parallel_for(), which always takes part in the work.
+    // A pool of one thread runs everything inline.
+    explicit ThreadPool(unsigned threads);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    auto operator=(const ThreadPool&) -> ThreadPool& = delete;
+
+    [[nodiscard]] auto size() const -> std::size_t { return workers.size() + 1; }
+
+    // Calls fn(i) for every i in [0, n) and returns once all calls finished. Indices are claimed
+    // one at a time by whichever thread is free, the caller included, so uneven work balances out
+    // and calling parallel_for() from inside a task cannot deadlock the pool. The first exception
+    // thrown by fn is rethrown here.
+    template <typename Fn>
+    void parallel_for(std::size_t n, Fn&& fn) {
+        if (workers.empty() || n <= 1) {
+            for (std::size_t i = 0; i < n; i++) {
+                fn(i);
+            }
+            return;
+        }
+        auto job = std::make_shared<Job>(n, [&fn](std::size_t i) { fn(i); });
+        const auto helpers = std::min(workers.size(), n - 1);
+        for (std::size_t i = 0; i < helpers; i++) {
+            enqueue([job] { job->run(); });
+        }
+        job->run();
+        job->wait();
+    }
+
+   private:
+    struct Job {
+        Job(std::size_t p_count, std::function<void(std::size_t)> p_body)
+            : count(p_count), body(std::move(p_body)) {}
+
+        void run();
+        void wait();
+
+        const std::size_t count;
+        // only called for claimed indices, helpers that start after the last index was claimed
+        // never touch it, so it may refer to the caller's stack
+        const std::function<void(std::size_t)> body;
+        std::atomic<std::size_t> next = 0;
+        std::mutex mutex = {};
+        std::condition_variable all_done = {};
+        std::size_t finished = 0;
+        std::exception_ptr error = nullptr;
+    };
+
+    void enqueue(std::function<void()> task);
+    void worker_loop();
+
+    std::vector<std::thread> workers = {};
+    std::deque<std::function<void()>> tasks = {};
+    std::mutex mutex = {};
+    std::condition_variable task_available = {};
+    bool stopping = false;
+};
+
+// number of threads to use for -j0
+[[nodiscard]] auto default_thread_count() -> unsigned;
+
+}  // namespace support
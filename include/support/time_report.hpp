@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "trace.hpp"
+
+namespace support {
+
+// Which cpu time a phase is charged. A phase that runs work on the thread pool is charged the
+// cpu time of the whole process, which also includes whatever else runs at the same time, such as
+// other files compiled concurrently.
+enum class CpuClock { Thread, Process };
+
+struct PhaseRecord {
+    std::string name;
+    double wall_ms = 0;
+    double cpu_ms = 0;
+    CpuClock cpu_clock = CpuClock::Thread;
+    // growth of the process' peak resident set while the phase ran, which also includes whatever
+    // else runs at the same time
+    long peak_rss_delta_kib = 0;
+    std::size_t objects = 0;
+    std::string object_kind = "";
+};
+
+class TimeReport;
+
+struct ClockSample {
+    double wall_ms = 0;
+    double cpu_ms = 0;
+    long peak_rss_kib = 0;
+
+    [[nodiscard]] static auto now(CpuClock cpu_clock = CpuClock::Thread) -> ClockSample;
+};
+
+// Samples the clocks when a phase starts; finish() records the phase in its report. Does
+// nothing when the owning report is disabled, so the compile path can always create one. The
+// phase is also a trace span when tracing is enabled.
+class PhaseTimer {
+   public:
+    PhaseTimer(TimeReport& report, std::string_view name, CpuClock cpu_clock);
+
+    // `count` is only invoked when the report is enabled, and after the clocks were read, walking
+    // a tree to count its nodes is not free.
+    template <typename Count>
+    void finish(std::string_view object_kind, Count&& count) {
+        span.end();
+        if (enabled) {
+            const auto end = ClockSample::now(cpu_clock);
+            record(end, object_kind, count());
+        }
+    }
+
+   private:
+    void record(const ClockSample& end, std::string_view object_kind, std::size_t objects);
+
+    std::reference_wrapper<TimeReport> report;
+    std::string name;
+    CpuClock cpu_clock;
+    bool enabled;
+    ClockSample start = {};
+    trace::Span span;
+};
+
+class TimeReport {
+   public:
+    explicit TimeReport(bool p_enabled, std::string p_file = "")
+        : enabled(p_enabled), file(std::move(p_file)) {}
+
+    [[nodiscard]] auto is_enabled() const -> bool { return enabled; }
+    [[nodiscard]] auto start(std::string_view phase, CpuClock cpu_clock = CpuClock::Thread)
+        -> PhaseTimer {
+        return {*this, phase, cpu_clock};
+    }
+    void add(PhaseRecord record) { phases.push_back(std::move(record)); }
+    [[nodiscard]] auto get_phases() const -> const std::vector<PhaseRecord>& { return phases; }
+    // event counters such as cache hits, reported after the phases
+    void count(const std::string& counter, std::size_t n = 1) {
+        if (enabled) {
+            counters[counter] += n;
+        }
+    }
+    [[nodiscard]] auto get_counters() const -> const std::map<std::string, std::size_t>& {
+        return counters;
+    }
+
+    void print(std::ostream& os) const;
+    void print_json(std::ostream& os) const;
+
+   private:
+    bool enabled;
+    std::string file;
+    std::vector<PhaseRecord> phases = {};
+    std::map<std::string, std::size_t> counters = {};
+};
+
+[[nodiscard]] auto wall_clock_ms() -> double;
+// cpu time of the calling thread, or of every thread of the process
+[[nodiscard]] auto cpu_clock_ms(CpuClock clock = CpuClock::Thread) -> double;
+// of the whole process
+[[nodiscard]] auto peak_rss_kib() -> long;
+
+}  // namespace support
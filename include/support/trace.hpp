@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// Chrome / Perfetto trace event collection (chrome://tracing, ui.perfetto.dev). Spans are
+// recorded as complete ("X") events; spans opened inside another span on the same thread show
+// up nested under it.
+namespace support::trace {
+
+void enable();
+[[nodiscard]] auto is_enabled() -> bool;
+// writes every span recorded so far as a trace event json file
+void write(const std::string& path);
+
+class Span {
+   public:
+    // `detail` is shown as an argument of the event, e.g. the function a pass is working on.
+    // Nothing is copied or timed while tracing is disabled.
+    explicit Span(std::string_view p_name, std::string_view p_detail = "");
+    Span(Span&& other) noexcept;
+    auto operator=(Span&& other) noexcept -> Span&;
+    Span(const Span&) = delete;
+    auto operator=(const Span&) -> Span& = delete;
+    ~Span();
+
+    // records the span now instead of at destruction
+    void end();
+
+   private:
+    bool active = false;
+    double start_us = 0;
+    std::string name = "";
+    std::string detail = "";
+};
+
+}  // namespace support::trace
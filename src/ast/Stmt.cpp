@@ -44,6 +44,11 @@ std::string Stmt::toString() const {
     return std::visit([](const auto& v_node) { return v_node->toString(); }, node);
 }
 
+std::ostream& Stmt::print(std::ostream& os) const {
+    return std::visit([&os](const auto& v_node) -> std::ostream& { return v_node->print(os); },
+                      node);
+}
+
 auto BodyNode::is_stmt() const -> bool { return std::holds_alternative<Stmt>(node); }
 
 auto BodyNode::is_move() const -> bool {
@@ -63,10 +68,22 @@ auto BodyNode::toString() const -> std::string {
     return std::get<std::shared_ptr<MoveAstNode>>(node)->toString();
 }
 
+auto BodyNode::print(std::ostream& os) const -> std::ostream& {
+    if (is_stmt()) {
+        return std::get<Stmt>(node).print(os);
+    }
+    return std::get<std::shared_ptr<MoveAstNode>>(node)->print(os);
+}
+
 auto ExprNode::toString() const -> std::string {
     return std::visit([](const auto& v_node) { return v_node->toString(); }, node);
 }
 
+auto ExprNode::print(std::ostream& os) const -> std::ostream& {
+    return std::visit([&os](const auto& v_node) -> std::ostream& { return v_node->print(os); },
+                      node);
+}
+
 const std::string ExprNode::get_variable_name() const {
     if (std::holds_alternative<std::shared_ptr<VariableAstNode>>(node)) {
         return std::get<std::shared_ptr<VariableAstNode>>(node)->name;
@@ -1,6 +1,9 @@
 #include "../../include/ast/ast.hpp"
 
 #include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <sstream>
 
 namespace ast {
 
@@ -42,12 +45,265 @@ inline const std::vector<BinOpKind> comparison_operators = {BinOpKind::Eq, BinOp
            comparison_operators.end();
 }
 
-[[nodiscard]] auto MoveAstNode::toString() const -> std::string {
+[[nodiscard]] auto print_to_string(const AstNode& node) -> std::string {
+    std::ostringstream os;
+    node.print(os);
+    return os.str();
+}
+
+[[nodiscard]] auto MoveAstNode::toString() const -> std::string { return print_to_string(*this); }
+
+auto MoveAstNode::print(std::ostream& os) const -> std::ostream& {
+    lhs.print(os) << " = ";
     if (rhs.has_value()) {
-        return lhs.toString() + " = " + rhs.value().toString();
+        return rhs.value().print(os);
+    }
+
+    return os << ";";
+}
+
+namespace {
+
+[[nodiscard]] auto count_nodes(const ExprNode& expr) -> std::size_t;
+[[nodiscard]] auto count_nodes(const std::vector<BodyNode>& body) -> std::size_t;
+
+template <typename T>
+[[nodiscard]] auto count_nodes(const std::shared_ptr<T>&) -> std::size_t {
+    return 1;
+}
+
+[[nodiscard]] auto count_nodes(const std::shared_ptr<DerefReadAstNode>& node) -> std::size_t {
+    return 1 + count_nodes(node->expr);
+}
+
+[[nodiscard]] auto count_nodes(const std::shared_ptr<DerefWriteAstNode>& node) -> std::size_t {
+    return 1 + count_nodes(node->expr);
+}
+
+[[nodiscard]] auto count_nodes(const std::shared_ptr<AddrAstNode>& node) -> std::size_t {
+    return 1 + count_nodes(node->expr);
+}
+
+[[nodiscard]] auto count_nodes(const std::shared_ptr<BinaryOpAstNode>& node) -> std::size_t {
+    return 1 + count_nodes(node->lhs) + count_nodes(node->rhs);
+}
+
+[[nodiscard]] auto count_nodes(const std::shared_ptr<MoveAstNode>& node) -> std::size_t {
+    auto count = 1 + count_nodes(node->lhs);
+    if (node->rhs.has_value()) {
+        count += count_nodes(node->rhs.value());
+    }
+    return count;
+}
+
+[[nodiscard]] auto count_nodes(const std::shared_ptr<FunctionCallAstNode>& node) -> std::size_t {
+    std::size_t count = 1;
+    for (const auto& arg : node->callArgs) {
+        count += count_nodes(arg);
+    }
+    return count;
+}
+
+[[nodiscard]] auto count_nodes(const std::shared_ptr<ReturnAstNode>& node) -> std::size_t {
+    return 1 + count_nodes(node->expr);
+}
+
+[[nodiscard]] auto count_nodes(const std::shared_ptr<IfNode>& node) -> std::size_t {
+    auto count = 1 + count_nodes(node->condition) + count_nodes(node->then);
+    if (node->else_.has_value()) {
+        count += count_nodes(node->else_.value());
+    }
+    return count;
+}
+
+[[nodiscard]] auto count_nodes(const std::shared_ptr<ForLoopAstNode>& node) -> std::size_t {
+    auto count = 1 + count_nodes(node->forInit) + count_nodes(node->forBody);
+    if (node->forCondition.has_value()) {
+        count += count_nodes(node->forCondition.value());
+    }
+    if (node->forUpdate.has_value()) {
+        count += count_nodes(node->forUpdate.value());
+    }
+    return count;
+}
+
+[[nodiscard]] auto count_nodes(const std::shared_ptr<FrameAstNode>& node) -> std::size_t {
+    return 1 + count_nodes(node->body);
+}
+
+auto count_nodes(const ExprNode& expr) -> std::size_t {
+    return std::visit([](const auto& node) { return count_nodes(node); }, expr.node);
+}
+
+auto count_nodes(const std::vector<BodyNode>& body) -> std::size_t {
+    std::size_t count = 0;
+    for (const auto& body_node : body) {
+        if (body_node.is_stmt()) {
+            const auto& stmt = std::get<Stmt>(body_node.node);
+            count += std::visit([](const auto& node) { return count_nodes(node); }, stmt.node);
+        } else {
+            count += count_nodes(std::get<std::shared_ptr<MoveAstNode>>(body_node.node));
+        }
+    }
+    return count;
+}
+
+void fingerprint(std::string& out, const ExprNode& expr);
+void fingerprint(std::string& out, const std::vector<BodyNode>& body);
+
+void fingerprint_field(std::string& out, std::string_view field) {
+    out += std::to_string(field.size());
+    out += ':';
+    out += field;
+}
+
+void fingerprint(std::string& out, const DataType& type) {
+    out += "t" + std::to_string(type.base_type) + "," + std::to_string(type.points_to) + "," +
+           std::to_string(type.array_size) + "," + std::to_string(type.indirect_level) + ";";
+}
+
+void fingerprint(std::string& out, const std::shared_ptr<ConstIntAstNode>& node) {
+    out += "i" + std::to_string(node->value) + ";";
+}
+
+void fingerprint(std::string& out, const std::shared_ptr<ConstFloatNode>& node) {
+    out += "f" + std::to_string(std::bit_cast<std::uint32_t>(node->value)) + ";";
+}
+
+void fingerprint(std::string& out, const std::shared_ptr<VariableAstNode>& node) {
+    out += "v";
+    fingerprint_field(out, node->name);
+    fingerprint(out, node->type);
+}
+
+void fingerprint(std::string& out, const std::shared_ptr<DerefReadAstNode>& node) {
+    out += "r(";
+    fingerprint(out, node->expr);
+    out += ")";
+}
+
+void fingerprint(std::string& out, const std::shared_ptr<DerefWriteAstNode>& node) {
+    out += "w(";
+    fingerprint(out, node->expr);
+    out += ")";
+}
+
+void fingerprint(std::string& out, const std::shared_ptr<AddrAstNode>& node) {
+    out += "a(";
+    fingerprint(out, node->expr);
+    out += ")";
+}
+
+void fingerprint(std::string& out, const std::shared_ptr<BinaryOpAstNode>& node) {
+    out += "b" + bin_op_to_string(node->kind) + "(";
+    fingerprint(out, node->lhs);
+    out += ",";
+    fingerprint(out, node->rhs);
+    out += ")";
+}
+
+void fingerprint(std::string& out, const std::shared_ptr<MoveAstNode>& node) {
+    out += "m(";
+    fingerprint(out, node->lhs);
+    if (node->rhs.has_value()) {
+        out += ",";
+        fingerprint(out, node->rhs.value());
     }
+    out += ")";
+}
 
-    return lhs.toString() + " = " + ";";
+void fingerprint(std::string& out, const std::shared_ptr<FunctionCallAstNode>& node) {
+    out += "c";
+    fingerprint_field(out, node->callName);
+    fingerprint(out, node->returnType);
+    out += "(";
+    for (const auto& arg : node->callArgs) {
+        fingerprint(out, arg);
+        out += ",";
+    }
+    out += ")";
+}
+
+void fingerprint(std::string& out, const std::shared_ptr<ReturnAstNode>& node) {
+    out += "ret(";
+    fingerprint(out, node->expr);
+    out += ")";
+}
+
+void fingerprint(std::string& out, const std::shared_ptr<JumpAstNode>& node) {
+    out += "j";
+    fingerprint_field(out, node->jumpToLabelValue);
+}
+
+void fingerprint(std::string& out, const std::shared_ptr<IfNode>& node) {
+    out += "if(";
+    fingerprint(out, node->condition);
+    out += "){";
+    fingerprint(out, node->then);
+    out += "}";
+    if (node->else_.has_value()) {
+        out += "else{";
+        fingerprint(out, node->else_.value());
+        out += "}";
+    }
+}
+
+void fingerprint(std::string& out, const std::shared_ptr<ForLoopAstNode>& node) {
+    out += "for(";
+    if (node->forInit) {
+        fingerprint(out, node->forInit);
+    }
+    out += ";";
+    if (node->forCondition.has_value()) {
+        fingerprint(out, node->forCondition.value());
+    }
+    out += ";";
+    if (node->forUpdate.has_value()) {
+        fingerprint(out, node->forUpdate.value());
+    }
+    out += "){";
+    fingerprint(out, node->forBody);
+    out += "}";
+}
+
+void fingerprint(std::string& out, const ExprNode& expr) {
+    std::visit([&out](const auto& node) { fingerprint(out, node); }, expr.node);
+}
+
+void fingerprint(std::string& out, const std::vector<BodyNode>& body) {
+    for (const auto& body_node : body) {
+        if (body_node.is_stmt()) {
+            const auto& stmt = std::get<Stmt>(body_node.node);
+            std::visit([&out](const auto& node) { fingerprint(out, node); }, stmt.node);
+        } else {
+            fingerprint(out, std::get<std::shared_ptr<MoveAstNode>>(body_node.node));
+        }
+        out += "\n";
+    }
+}
+
+}  // namespace
+
+auto fingerprint(const FrameAstNode& frame) -> std::string {
+    std::string out = "fn";
+    fingerprint_field(out, frame.name);
+    out += "(";
+    for (const auto& param : frame.params) {
+        fingerprint_field(out, param.name);
+        fingerprint(out, param.type);
+    }
+    out += "){\n";
+    fingerprint(out, frame.body);
+    out += "}";
+    return out;
+}
+
+auto count_nodes(const std::vector<TopLevelNode>& nodes) -> std::size_t {
+    std::size_t count = 0;
+    for (const auto& top_level : nodes) {
+        count += std::visit([](const auto& node) { return count_nodes(node); }, top_level.node);
+    }
+    return count;
 }
 
 }  // namespace ast
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include "../include/compile_cache.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../include/support/sha256.hpp"
+
+#ifndef QAC_VERSION
+#define QAC_VERSION "unknown"
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr std::string_view entry_extension = ".asm";
+constexpr std::string_view temporary_prefix = ".tmp-";
+// older temporaries belong to a store that will never finish, any running one takes milliseconds
+constexpr auto abandoned_temporary_age = std::chrono::hours(1);
+
+// Identifies the compiler that produced an entry: the release plus the size and mtime of the
+// running executable, so a rebuilt qac never reuses assembly from an older build.
+[[nodiscard]] auto compiler_build_id() -> const std::string& {
+    static const std::string id = [] {
+        std::string build = "qac " QAC_VERSION;
+        std::error_code ec;
+        const auto executable = fs::read_symlink("/proc/self/exe", ec);
+        if (!ec) {
+            build += " " + std::to_string(fs::file_size(executable, ec));
+            build += " " + std::to_string(
+                               fs::last_write_time(executable, ec).time_since_epoch().count());
+        }
+        return build;
+    }();
+    return id;
+}
+
+// unique per process and thread, so concurrent stores never write the same temporary file
+[[nodiscard]] auto temporary_name() -> std::string {
+    static std::atomic<unsigned long> counter = 0;
+    return std::string(temporary_prefix) + std::to_string(getpid()) + "-" +
+           std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + "-" +
+           std::to_string(counter++);
+}
+
+// marks the entry as recently used for eviction
+void touch(const fs::path& entry) {
+    std::error_code ec;
+    fs::last_write_time(entry, fs::file_time_type::clock::now(), ec);
+}
+
+}  // namespace
+
+CompileCache::CompileCache(fs::path p_directory, std::uintmax_t p_max_bytes)
+    : directory(std::move(p_directory)), max_bytes(p_max_bytes) {}
+
+auto CompileCache::key(std::string_view kind, std::string_view contents) const -> std::string {
+    support::Sha256 hash;
+    hash.update_field(compiler_build_id());
+    // No DriverOptions field changes the generated assembly today: -j output is identical and
+    // --dump bypasses the cache. Options that affect code generation must be hashed here.
+    hash.update_field("options:");
+    hash.update_field(kind);
+    hash.update_field(contents);
+    return hash.hex_digest();
+}
+
+auto CompileCache::entry_path(const std::string& key) const -> fs::path {
+    return directory / (key + std::string(entry_extension));
+}
+
+auto CompileCache::fetch(const std::string& key, const std::string& outfile) const -> bool {
+    // copied rather than hard linked: write_to_file() truncates its output in place, which would
+    // rewrite a linked entry on the next compile
+    const auto entry = entry_path(key);
+    std::error_code ec;
+    fs::copy_file(entry, outfile, fs::copy_options::overwrite_existing, ec);
+    if (ec) {
+        return false;
+    }
+    touch(entry);
+    return true;
+}
+
+auto CompileCache::load(const std::string& key) const -> std::optional<std::string> {
+    const auto entry = entry_path(key);
+    std::ifstream in(entry, std::ios::binary);
+    if (!in.is_open()) {
+        return std::nullopt;
+    }
+    std::ostringstream contents;
+    contents << in.rdbuf();
+    touch(entry);
+    return contents.str();
+}
+
+auto CompileCache::store(const std::string& key, std::string_view contents) const -> bool {
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    if (ec) {
+        return false;
+    }
+    const auto temporary = directory / temporary_name();
+    {
+        std::ofstream out(temporary, std::ios::binary);
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        if (!out.flush()) {
+            fs::remove(temporary, ec);
+            return false;
+        }
+    }
+    fs::rename(temporary, entry_path(key), ec);
+    if (ec) {
+        fs::remove(temporary, ec);
+        return false;
+    }
+    return true;
+}
+
+void CompileCache::evict() const {
+    struct Entry {
+        fs::path path;
+        std::uintmax_t size;
+        fs::file_time_type last_used;
+    };
+    std::vector<Entry> entries;
+    std::uintmax_t total = 0;
+    std::error_code ec;
+    const auto now = fs::file_time_type::clock::now();
+    for (const auto& file : fs::directory_iterator(directory, ec)) {
+        if (file.path().filename().string().starts_with(temporary_prefix)) {
+            const auto written = file.last_write_time(ec);
+            if (!ec && now - written > abandoned_temporary_age) {
+                fs::remove(file.path(), ec);
+            }
+            continue;
+        }
+        if (file.path().extension() != entry_extension) {
+            continue;
+        }
+        const auto size = file.file_size(ec);
+        const auto last_used = file.last_write_time(ec);
+        // gone already, another process is evicting as well
+        if (ec) {
+            continue;
+        }
+        entries.push_back(Entry{file.path(), size, last_used});
+        total += size;
+    }
+    if (total <= max_bytes) {
+        return;
+    }
+
+    std::ranges::sort(entries, {}, &Entry::last_used);
+    for (const auto& entry : entries) {
+        if (total <= max_bytes) {
+            break;
+        }
+        fs::remove(entry.path, ec);
+        total -= entry.size;
+    }
+}
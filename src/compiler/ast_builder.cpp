@@ -0,0 +1,210 @@
+#include "../../include/compiler/ast_builder.hpp"
+
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace ast {
+
+namespace {
+
+// `target` as translate() makes it on the left of an `=`, where every dereference writes
+[[nodiscard]] auto as_target(ExprNode target) -> ExprNode {
+    auto& node = target.node;
+    if (const auto* read = std::get_if<std::shared_ptr<DerefReadAstNode>>(&node)) {
+        return std::make_shared<DerefWriteAstNode>(as_target((*read)->expr));
+    }
+    if (const auto* write = std::get_if<std::shared_ptr<DerefWriteAstNode>>(&node)) {
+        (*write)->expr = as_target((*write)->expr);
+    } else if (const auto* addr = std::get_if<std::shared_ptr<AddrAstNode>>(&node)) {
+        (*addr)->expr = as_target((*addr)->expr);
+    } else if (const auto* binary = std::get_if<std::shared_ptr<BinaryOpAstNode>>(&node)) {
+        (*binary)->lhs = as_target((*binary)->lhs);
+        (*binary)->rhs = as_target((*binary)->rhs);
+    } else if (const auto* call = std::get_if<std::shared_ptr<FunctionCallAstNode>>(&node)) {
+        for (auto& arg : (*call)->callArgs) {
+            arg = as_target(arg);
+        }
+    }
+    return target;
+}
+
+[[nodiscard]] auto bin_op_kind(BinaryOp op) -> BinOpKind {
+    switch (op) {
+        case BinaryOp::EQ:
+            return BinOpKind::Eq;
+        case BinaryOp::NEQ:
+            return BinOpKind::Neq;
+        case BinaryOp::LT:
+            return BinOpKind::Lt;
+        case BinaryOp::GT:
+            return BinOpKind::Gt;
+        case BinaryOp::ADD:
+            return BinOpKind::Add;
+        case BinaryOp::SUB:
+            return BinOpKind::Sub;
+        case BinaryOp::MUL:
+            return BinOpKind::Mul;
+        case BinaryOp::DIV:
+            return BinOpKind::Div;
+        case BinaryOp::ASSIGN:
+        case BinaryOp::NONE:
+            break;
+    }
+    throw std::logic_error("not a binary operation");
+}
+
+}  // namespace
+
+AstBuilder::AstBuilder()
+    : declarations(), ctx{.tree = &declarations, .counter = 0, .local_variables = {}} {}
+
+auto AstBuilder::primary(st::PrimaryExpression expr) -> Expression {
+    return Expression{.node = translate(expr, ctx), .primary = expr};
+}
+
+// calls and array accesses are only supported on names
+auto AstBuilder::callee_name(const Expression& callee) const -> std::string_view {
+    if (!callee.primary.has_value()) {
+        throw std::runtime_error("Expected a name before '(' or '['");
+    }
+    return callee.primary->idenValue;
+}
+
+auto AstBuilder::call(std::string_view name, std::span<Expression> args) -> Expression {
+    std::vector<ExprNode> nodes;
+    nodes.reserve(args.size());
+    bool contains_assignment = false;
+    for (auto& arg : args) {
+        nodes.push_back(std::move(arg.node));
+        contains_assignment = contains_assignment || arg.contains_assignment;
+    }
+    return Expression{.node = function_call(name, std::move(nodes)),
+                      .contains_assignment = contains_assignment};
+}
+
+auto AstBuilder::array_access(std::string_view name, Expression index) -> Expression {
+    return Expression{.node = ast::array_access(name, std::move(index.node), ctx),
+                      .contains_assignment = index.contains_assignment};
+}
+
+auto AstBuilder::unary(st::UnaryExpressionType type, Expression operand) -> Expression {
+    const auto* literal = operand.primary.has_value() ? &*operand.primary : nullptr;
+    return Expression{.node = unary_operation(type, std::move(operand.node), literal, ctx),
+                      .contains_assignment = operand.contains_assignment};
+}
+
+auto AstBuilder::begin_right_operand(BinaryOp op, Expression& lhs) -> void {
+    if (op != BinaryOp::ASSIGN) {
+        return;
+    }
+    if (lhs.contains_assignment) {
+        throw NotReproducible("Assignment inside the target of an assignment");
+    }
+    lhs.node = as_target(std::move(lhs.node));
+    ctx.set_lvalueContext("AstBuilder::begin_right_operand()", false);
+}
+
+auto AstBuilder::binary(BinaryOp op, Expression lhs, Expression rhs) -> Expression {
+    if (op == BinaryOp::ASSIGN) {
+        return Expression{
+            .node = std::make_shared<MoveAstNode>(std::move(lhs.node), std::move(rhs.node)),
+            .contains_assignment = true};
+    }
+    return Expression{.node = std::make_shared<BinaryOpAstNode>(
+                          std::move(lhs.node), std::move(rhs.node), bin_op_kind(op)),
+                      .contains_assignment = lhs.contains_assignment || rhs.contains_assignment};
+}
+
+auto AstBuilder::array_size(const Expression& size) -> st::Expression {
+    if (!size.primary.has_value()) {
+        throw std::runtime_error("Array size must be a constant");
+    }
+    return declarations.add_expression(*size.primary);
+}
+
+auto AstBuilder::begin_return() -> void {
+    ctx.set_lvalueContext("AstBuilder::begin_return()", false);
+}
+
+auto AstBuilder::return_statement(Expression expr) -> Statement {
+    ctx.set_lvalueContext("AstBuilder::return_statement()", true);
+    return std::make_shared<ReturnAstNode>(std::move(expr.node));
+}
+
+auto AstBuilder::expression_statement(const Expression& expr) -> Statement {
+    return ast::expression_statement(expr.node);
+}
+
+auto AstBuilder::if_statement(Expression cond, CompoundStatement then,
+                              std::optional<CompoundStatement> else_) -> Statement {
+    return std::make_shared<IfNode>(translate_condition(std::move(cond.node), ctx),
+                                    std::move(then), std::move(else_));
+}
+
+auto AstBuilder::for_statement(Declaration init, std::optional<Expression> cond,
+                               std::optional<Expression> inc, CompoundStatement body)
+    -> Statement {
+    if (!init->rhs.has_value()) {
+        throw std::runtime_error("Expected an initializer in the for loop declaration");
+    }
+    std::optional<std::shared_ptr<BinaryOpAstNode>> forCondition;
+    std::optional<ExprNode> forUpdate;
+    if (cond) {
+        forCondition = translate_condition(std::move(cond->node), ctx);
+    }
+    if (inc) {
+        forUpdate = std::move(inc->node);
+    }
+    return std::make_shared<ForLoopAstNode>(std::move(init), std::move(forCondition),
+                                            std::move(forUpdate), std::move(body));
+}
+
+auto AstBuilder::block(std::span<BlockItem> items) -> CompoundStatement {
+    return CompoundStatement(std::make_move_iterator(items.begin()),
+                             std::make_move_iterator(items.end()));
+}
+
+auto AstBuilder::declare(st::NodeList<st::DeclarationSpecifier> specifiers,
+                         const st::Declarator& declarator) -> std::shared_ptr<VariableAstNode> {
+    const auto decl = st::Declaration{
+        .declarationSpecifiers = specifiers,
+        .initDeclarator = st::InitDeclarator{.declarator = declarator, .initializer = std::nullopt},
+    };
+    return declare_variable(decl, ctx);
+}
+
+auto AstBuilder::begin_initializer() -> void {
+    ctx.set_lvalueContext("AstBuilder::begin_initializer()", false);
+}
+
+auto AstBuilder::declaration(std::shared_ptr<VariableAstNode> declared,
+                             std::optional<Expression> initializer) -> Declaration {
+    if (!initializer.has_value()) {
+        return std::make_shared<MoveAstNode>(
+            std::make_shared<VariableAstNode>(declared->name, declared->type), std::nullopt);
+    }
+    ctx.set_lvalueContext("AstBuilder::declaration()", true);
+    return std::make_shared<MoveAstNode>(std::move(declared), std::move(initializer->node));
+}
+
+auto AstBuilder::begin_function(st::NodeList<st::DeclarationSpecifier> specifiers,
+                                const st::Declarator& declarator) -> Function {
+    const st::FuncDef fd(specifiers, declarator, st::CompoundStatement{});
+    auto name = fd.Name();
+    auto params = declare_parameters(fd, ctx);
+    return Function{.name = std::move(name), .params = std::move(params)};
+}
+
+auto AstBuilder::function(Function fn, CompoundStatement body) -> ExternalDeclaration {
+    return TopLevelNode{
+        std::make_shared<FrameAstNode>(fn.name, std::move(body), std::move(fn.params))};
+}
+
+auto AstBuilder::external(Declaration decl) -> ExternalDeclaration {
+    return TopLevelNode{std::move(decl)};
+}
+
+auto AstBuilder::program(std::vector<ExternalDeclaration> nodes) -> Program { return nodes; }
+
+}  // namespace ast
@@ -11,6 +11,8 @@
 #include <variant>
 #include <vector>
 
+#include "../../../include/support/trace.hpp"
+
 namespace qa_ir {
 
 namespace {
@@ -558,18 +560,22 @@ auto generate_ir_for_frame(ast::FrameAstNode* function, F_Ctx& ctx) -> Frame {
 #pragma GCC diagnostic pop
 }  // namespace
 
+auto Produce_IR(ast::TopLevelNode& node) -> Frame {
+    auto ctx = F_Ctx{.temp_counter = 0, .label_counter = 0, .variables = {}};
+    if (!node.is_function()) {
+        throw std::runtime_error("Only support functions at the top level.");
+    }
+
+    ast::FrameAstNode* function = node.get_function();
+    support::trace::Span span("Produce_IR", function->name);
+    return generate_ir_for_frame(function, ctx);
+}
+
 auto Produce_IR(std::vector<ast::TopLevelNode>& nodes) -> std::vector<Frame> {
     std::vector<Frame> frames;
 
     for (auto& node : nodes) {
-        auto ctx = F_Ctx{.temp_counter = 0, .label_counter = 0, .variables = {}};
-        if (!node.is_function()) {
-            throw std::runtime_error("Only support functions at the top level.");
-        }
-
-        ast::FrameAstNode* function = node.get_function();
-        const auto frame = generate_ir_for_frame(function, ctx);
-        frames.push_back(frame);
+        frames.push_back(Produce_IR(node));
     }
 
     return frames;
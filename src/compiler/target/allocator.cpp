@@ -1,6 +1,7 @@
 #include "../../../include/compiler/target/allocator.hpp"
 
 #include "../../../include/compiler/target/qa_x86.hpp"
+#include "../../../include/support/trace.hpp"
 
 namespace target {
 [[nodiscard]] auto getFirstUse(const Frame& frame) -> FirstLastUse;
@@ -168,11 +169,16 @@ auto remap(Frame& frame) -> std::map<VirtualRegister, VirtualRegister> {
     return newFrame;
 }
 
+[[nodiscard]] Frame rewrite(const Frame& frame) {
+    support::trace::Span span("rewrite", frame.name);
+    AllocatorContext ctx;
+    return rewrite(frame, ctx);
+}
+
 [[nodiscard]] std::vector<Frame> rewrite(const std::vector<Frame>& frames) {
     std::vector<Frame> newFrames;
     for (const auto& frame : frames) {
-        AllocatorContext ctx;
-        newFrames.push_back(rewrite(frame, ctx));
+        newFrames.push_back(rewrite(frame));
     }
     return newFrames;
 }
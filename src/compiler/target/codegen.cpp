@@ -6,6 +6,7 @@
 #include "../../../include/compiler/target/codegenCtx.hpp"
 #include "../../../include/compiler/target/qa_x86.hpp"
 #include "../../../include/compiler/target/qa_x86_instructions.hpp"
+#include "../../../include/support/trace.hpp"
 
 namespace target {
 
@@ -31,12 +32,23 @@ void generateASMForFrame(const target::Frame& frame, CodegenContext& ctx) {
     ctx.AddInstruction("ret");
 }
 
-[[nodiscard]] std::string Generate(const std::vector<target::Frame>& frames) {
+[[nodiscard]] FrameAsm GenerateFrame(const target::Frame& frame) {
+    support::trace::Span span("Generate", frame.name);
+    CodegenContext ctx(frame.name);
+    generateASMForFrame(frame, ctx);
+    return FrameAsm{.data = std::move(ctx.DataSection), .code = std::move(ctx.Code)};
+}
+
+[[nodiscard]] std::string EmitProgram(const std::vector<FrameAsm>& frames) {
     CodegenContext ctx;
+    ctx.DataSection = "section .data\n";
+    for (const auto& frame : frames) {
+        ctx.DataSection += frame.data;
+    }
     ctx.AddInstructionNoIndent("section .text");
     ctx.AddInstructionNoIndent("global _start");
     for (const auto& frame : frames) {
-        generateASMForFrame(frame, ctx);
+        ctx.Code += frame.code;
     }
     ctx.AddInstructionNoIndent("_start:");
     ctx.AddInstruction("call main");
@@ -45,4 +57,12 @@ void generateASMForFrame(const target::Frame& frame, CodegenContext& ctx) {
     ctx.AddInstruction("syscall");
     return ctx.DataSection + ctx.Code;
 }
+
+[[nodiscard]] std::string Generate(const std::vector<target::Frame>& frames) {
+    std::vector<FrameAsm> code;
+    for (const auto& frame : frames) {
+        code.push_back(GenerateFrame(frame));
+    }
+    return EmitProgram(code);
+}
 }  // namespace target
\ No newline at end of file
@@ -7,12 +7,12 @@ void CodegenContext::AddInstruction(const std::string& i) { Code += "\t" + i + "
 
 //  ideally the assembly looks like this.
 // section .data
-// a: dd 5.000
-// b: dd 1.0000
-// c: dd 5.50000
+// float_constant_main_0: dd 5.000
+// float_constant_main_1: dd 1.0000
+// float_constant_max_0: dd 5.50000
 
 std::string CodegenContext::DefineFloatConstant(float value) {
-    const auto name = "float_constant_" + std::to_string(float_counter++);
+    const auto name = "float_constant_" + frame_name + "_" + std::to_string(float_counter++);
     const auto ins = name + ": dd " + std::to_string(value);
     DataSection += ins + "\n";
     return name;
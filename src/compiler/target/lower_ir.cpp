@@ -9,14 +9,13 @@
 
 #include "../../../include/ast/ast.hpp"
 #include "../../../include/compiler/target/qa_x86.hpp"
+#include "../../../include/support/trace.hpp"
 
 namespace target {
 using bt = ast::BaseType;
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 
-bool l_value_ctx = false;
-
 template <typename ImmediateType>
 [[nodiscard]] ins_list _Value_To_Location(Register r_dst, qa_ir::Immediate<ImmediateType> v_src,
                                           Ctx* ctx) {
@@ -129,9 +128,7 @@ StackLocation Ctx::get_stack_location(const qa_ir::Variable& v, ins_list& instru
 }
 
 Register newRegisterForVariable(qa_ir::Variable operand, Ctx& ctx) {
-    std::cout << "newregisterfor: " << operand.name << std::endl;
     if (operand.type.is_float()) {
-        std::cout << "float" << std::endl;
         return ctx.NewFloatRegister(4);
     }
     if (operand.type.is_int()) {
@@ -166,7 +163,6 @@ Register newRegisterforValue(qa_ir::Value operand, Ctx& ctx) {
 }
 
 VirtualRegister Ctx::NewIntegerRegister(int size) {
-    std::cout << "something called new int reg" << std::endl;
     if (size == 8) {
         return VirtualRegister{.id = tempCounter++, .size = size};
     }
@@ -1277,9 +1273,7 @@ auto LowerInstruction(qa_ir::ConditionalJumpLess cj, Ctx& ctx) -> ins_list {
     auto variable_dest = deref.dst;
     // move the variable to a register
     const auto tempregister = ctx.NewIntegerRegister(8);
-    l_value_ctx = true;
     auto moveInstructions = ctx.LocationToLocation(tempregister, variable_dest);
-    l_value_ctx = false;
     result.insert(result.end(), moveInstructions.begin(), moveInstructions.end());
     // load the value at the address
     const auto src = deref.src;
@@ -1430,20 +1424,24 @@ auto LowerInstruction(qa_ir::Jump arg, Ctx& ctx) -> ins_list { return {Jump(arg.
 }
 #pragma GCC diagnostic pop
 
+[[nodiscard]] Frame LowerIR(const qa_ir::Frame& f) {
+    support::trace::Span span("LowerIR", f.name);
+    ins_list instructions;
+    Ctx ctx = Ctx{};
+    for (const auto& op : f.instructions) {
+        auto ins = GenerateInstructionsForOperation(op, ctx);
+        if (ins.empty()) {
+            continue;
+        }
+        instructions.insert(instructions.end(), ins.begin(), ins.end());
+    }
+    return Frame{f.name, instructions, ctx.get_stack_offset()};
+}
+
 [[nodiscard]] std::vector<Frame> LowerIR(const std::vector<qa_ir::Frame>& frames) {
     std::vector<Frame> result;
     for (const auto& f : frames) {
-        ins_list instructions;
-        Ctx ctx = Ctx{};
-        for (const auto& op : f.instructions) {
-            auto ins = GenerateInstructionsForOperation(op, ctx);
-            if (ins.empty()) {
-                continue;
-            }
-            instructions.insert(instructions.end(), ins.begin(), ins.end());
-        }
-        auto new_frame = Frame{f.name, instructions, ctx.get_stack_offset()};
-        result.push_back(new_frame);
+        result.push_back(LowerIR(f));
     }
     return result;
 }
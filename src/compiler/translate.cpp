@@ -1,23 +1,52 @@
 #include "../../include/compiler/translate.hpp"
 
+#include <algorithm>
+#include <iterator>
+#include <optional>
 #include <utility>
 
 #include "../../include/ast/asttraits.hpp"
+#include "../../include/support/thread_pool.hpp"
 
 namespace ast {
 
+void DeclarationHistory::add(std::size_t part, const Variables& declared) {
+    for (const auto& [name, var] : declared) {
+        declarations[name].emplace_back(part, var);
+    }
+}
+
+auto DeclarationHistory::find(const std::string& name, std::size_t part) const
+    -> const VariableAstNode* {
+    const auto it = declarations.find(name);
+    if (it == declarations.end()) {
+        return nullptr;
+    }
+    const auto& parts = it->second;
+    const auto later = std::lower_bound(
+        parts.begin(), parts.end(), part,
+        [](const auto& declared, std::size_t p) { return declared.first < p; });
+    return later == parts.begin() ? nullptr : std::prev(later)->second.get();
+}
+
+auto Ctx::find_variable(const std::string& name) const -> const VariableAstNode* {
+    if (const auto it = local_variables.find(name); it != local_variables.end()) {
+        return it->second.get();
+    }
+    return earlier_parts == nullptr ? nullptr : earlier_parts->find(name, part);
+}
+
 // primary
-auto translate(const std::shared_ptr<st::PrimaryExpression>& expr, Ctx& ctx) -> ExprNode {
-    if (expr->type == st::PrimaryExpressionType::INT) {
-        return std::make_shared<ConstIntAstNode>(expr->value);
-    } else if (expr->type == st::PrimaryExpressionType::FLOAT) {
-        return std::make_shared<ConstFloatNode>(expr->f_value);
+auto translate(const st::PrimaryExpression& expr, Ctx& ctx) -> ExprNode {
+    if (expr.type == st::PrimaryExpressionType::INT) {
+        return std::make_shared<ConstIntAstNode>(expr.value);
+    } else if (expr.type == st::PrimaryExpressionType::FLOAT) {
+        return std::make_shared<ConstFloatNode>(expr.f_value);
     }
 
-    if (expr->type == st::PrimaryExpressionType::IDEN) {
-        const auto iden = expr->idenValue;
-        if (ctx.local_variables.find(iden) != ctx.local_variables.end()) {
-            const auto var = ctx.local_variables[iden];
+    if (expr.type == st::PrimaryExpressionType::IDEN) {
+        const auto iden = std::string(expr.idenValue);
+        if (const auto* var = ctx.find_variable(iden)) {
             return std::make_shared<VariableAstNode>(iden, var->type);
         }
         throw std::runtime_error("Variable not found: " + iden);
@@ -25,12 +54,14 @@ auto translate(const std::shared_ptr<st::PrimaryExpression>& expr, Ctx& ctx) ->
     throw std::runtime_error("translate(st::PrimaryExpression *expr, Ctx &ctx) not implemented");
 }
 
-// primary
-auto translate(const std::shared_ptr<st::ArrayAccessExpression>& expr, Ctx& ctx) -> ExprNode {
-    std::string name = expr->name;
-    auto index = translate(expr->index, ctx);
-    const DataType dt = ctx.local_variables[name]->type;
-    if (ctx.__lvalueContext == false) {
+auto array_access(std::string_view name_view, ExprNode index, Ctx& ctx) -> ExprNode {
+    const std::string name(name_view);
+    const auto* var = ctx.find_variable(name);
+    if (var == nullptr) {
+        throw std::runtime_error("Variable not found: " + name);
+    }
+    const DataType dt = var->type;
+    if (ctx.lvalueContext() == false) {
         const auto binary = std::make_shared<BinaryOpAstNode>(
             std::make_shared<VariableAstNode>(name, dt), std::move(index), BinOpKind::Add);
         return std::make_shared<DerefReadAstNode>(std::move(binary));
@@ -40,32 +71,33 @@ auto translate(const std::shared_ptr<st::ArrayAccessExpression>& expr, Ctx& ctx)
     return std::make_shared<DerefWriteAstNode>(std::move(binary));
 }
 
+// primary
+auto translate(const st::ArrayAccessExpression& expr, Ctx& ctx) -> ExprNode {
+    auto index = translate(expr.index, ctx);
+    return array_access(expr.name, std::move(index), ctx);
+}
+
 // assignment
-auto translate(const std::shared_ptr<st::AssignmentExpression>& expr, Ctx& ctx) -> ExprNode {
+auto translate(const st::AssignmentExpression& expr, Ctx& ctx) -> ExprNode {
     ctx.set_lvalueContext("translate(const st::AssignmentExpression &expr, Ctx &ctx)", true);
-    auto lhs = translate(expr->lhs, ctx);
+    auto lhs = translate(expr.lhs, ctx);
     ctx.set_lvalueContext("translate(const st::AssignmentExpression &expr, Ctx &ctx)", false);
-    auto rhs = translate(expr->rhs, ctx);
+    auto rhs = translate(expr.rhs, ctx);
 
     return std::make_shared<MoveAstNode>(std::move(lhs), std::move(rhs));
 }
 
-// unary expression
-// assignment
-auto translate(const std::shared_ptr<st::UnaryExpression>& expr, Ctx& ctx) -> ExprNode {
-    auto e = translate(expr->expr, ctx);
-    if (expr->type == st::UnaryExpressionType::DEREF && ctx.__lvalueContext == false) {
+auto unary_operation(st::UnaryExpressionType type, ExprNode e,
+                     const st::PrimaryExpression* literal, Ctx& ctx) -> ExprNode {
+    if (type == st::UnaryExpressionType::DEREF && ctx.lvalueContext() == false) {
         return std::make_shared<DerefReadAstNode>(std::move(e));
-    } else if (expr->type == st::UnaryExpressionType::DEREF && ctx.__lvalueContext == true) {
+    } else if (type == st::UnaryExpressionType::DEREF && ctx.lvalueContext() == true) {
         return std::make_shared<DerefWriteAstNode>(std::move(e));
-    } else if (expr->type == st::UnaryExpressionType::ADDR) {
+    } else if (type == st::UnaryExpressionType::ADDR) {
         return std::make_shared<AddrAstNode>(std::move(e));
-    } else if (expr->type == st::UnaryExpressionType::NEG) {
-        if (std::holds_alternative<std::shared_ptr<st::PrimaryExpression>>(expr->expr)) {
-            auto primary = std::get<std::shared_ptr<st::PrimaryExpression>>(expr->expr);
-            if (primary->type == st::PrimaryExpressionType::INT) {
-                return std::make_shared<ConstIntAstNode>(-primary->value);
-            }
+    } else if (type == st::UnaryExpressionType::NEG) {
+        if (literal != nullptr && literal->type == st::PrimaryExpressionType::INT) {
+            return std::make_shared<ConstIntAstNode>(-literal->value);
         }
         return std::make_shared<BinaryOpAstNode>(std::make_shared<ConstIntAstNode>(0), std::move(e),
                                                  BinOpKind::Sub);
@@ -74,9 +106,18 @@ auto translate(const std::shared_ptr<st::UnaryExpression>& expr, Ctx& ctx) -> Ex
     throw std::runtime_error("translate(const st::UnaryExpression &expr, Ctx &ctx)");
 }
 
-auto translate(const std::shared_ptr<st::AdditiveExpression>& expr, Ctx& ctx) -> ExprNode {
-    auto lhs = translate(expr->lhs, ctx);
-    auto rhs = translate(expr->rhs, ctx);
+// unary expression
+auto translate(const st::UnaryExpression& expr, Ctx& ctx) -> ExprNode {
+    auto e = translate(expr.expr, ctx);
+    const auto* literal = expr.expr.kind == st::ExpressionKind::PRIMARY
+                              ? &ctx.tree->get<st::PrimaryExpression>(expr.expr)
+                              : nullptr;
+    return unary_operation(expr.type, std::move(e), literal, ctx);
+}
+
+auto translate(const st::AdditiveExpression& expr, Ctx& ctx) -> ExprNode {
+    auto lhs = translate(expr.lhs, ctx);
+    auto rhs = translate(expr.rhs, ctx);
     std::unordered_map<st::AdditiveExpressionType, BinOpKind> mp = {
         {st::AdditiveExpressionType::ADD, BinOpKind::Add},
         {st::AdditiveExpressionType::SUB, BinOpKind::Sub},
@@ -85,21 +126,21 @@ auto translate(const std::shared_ptr<st::AdditiveExpression>& expr, Ctx& ctx) ->
         {st::AdditiveExpressionType::GT, BinOpKind::Gt},
         {st::AdditiveExpressionType::LT, BinOpKind::Lt},
     };
-    if (mp.find(expr->type) != mp.end()) {
-        return std::make_shared<BinaryOpAstNode>(std::move(lhs), std::move(rhs), mp[expr->type]);
+    if (mp.find(expr.type) != mp.end()) {
+        return std::make_shared<BinaryOpAstNode>(std::move(lhs), std::move(rhs), mp[expr.type]);
     }
     throw std::runtime_error("translate(const st::AdditiveExpression &expr, Ctx &ctx)");
 }
 
-auto translate(const std::shared_ptr<st::MultiplicativeExpression>& expr, Ctx& ctx) -> ExprNode {
-    auto lhs = translate(expr->lhs, ctx);
-    auto rhs = translate(expr->rhs, ctx);
+auto translate(const st::MultiplicativeExpression& expr, Ctx& ctx) -> ExprNode {
+    auto lhs = translate(expr.lhs, ctx);
+    auto rhs = translate(expr.rhs, ctx);
     std::unordered_map<st::MultiplicativeExpressionType, BinOpKind> mp = {
         {st::MultiplicativeExpressionType::Mult, BinOpKind::Mul},
         {st::MultiplicativeExpressionType::Div, BinOpKind::Div},
     };
-    if (mp.find(expr->type) != mp.end()) {
-        return std::make_shared<BinaryOpAstNode>(std::move(lhs), std::move(rhs), mp[expr->type]);
+    if (mp.find(expr.type) != mp.end()) {
+        return std::make_shared<BinaryOpAstNode>(std::move(lhs), std::move(rhs), mp[expr.type]);
     }
     throw std::runtime_error("translate(const st::AdditiveExpression &expr, Ctx &ctx)");
 }
@@ -108,7 +149,7 @@ auto translate(const std::shared_ptr<st::MultiplicativeExpression>& expr, Ctx& c
 // so something like if(a) becomes if(a != 0)
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
-[[nodiscard]] auto translate_condition(ast::ExprNode condition, Ctx& ctx)
+auto translate_condition(ast::ExprNode condition, Ctx& ctx)
     -> std::shared_ptr<BinaryOpAstNode> {
     if (const auto kind = condition.get_bin_op()) {
         auto translatedCondition = condition.get_binary_op_node();
@@ -125,11 +166,24 @@ auto translate(const std::shared_ptr<st::MultiplicativeExpression>& expr, Ctx& c
 }
 #pragma GCC diagnostic pop
 
-auto translate(const std::shared_ptr<st::ForStatement>& stmt, Ctx& ctx) -> Stmt {
-    const st::ForDeclaration& init = stmt->init;
+namespace {
+
+auto declare_loop_variable(const st::ForDeclaration& init, Ctx& ctx)
+    -> std::shared_ptr<VariableAstNode> {
     const auto iden = init.initDeclarator.value().declarator.directDeclarator.VariableIden();
-    auto datatype = ast::toDataType(init);
-    ctx.local_variables[iden] = std::make_shared<VariableAstNode>(iden, datatype);
+    auto datatype = ast::toDataType(*ctx.tree, init);
+    auto var = std::make_shared<VariableAstNode>(iden, datatype);
+    ctx.local_variables[iden] = var;
+    return var;
+}
+
+}  // namespace
+
+auto translate(const st::ForStatement& stmt, Ctx& ctx) -> Stmt {
+    const st::ForDeclaration& init = stmt.init;
+    const auto declared = declare_loop_variable(init, ctx);
+    const auto& iden = declared->name;
+    const auto datatype = declared->type;
     const auto& expr = init.initDeclarator.value().initializer.value().expr;
     ctx.set_lvalueContext("translate(const std::unique_ptr<st::ForStatement> &stmt, Ctx &ctx)",
                           false);
@@ -143,78 +197,88 @@ auto translate(const std::shared_ptr<st::ForStatement>& stmt, Ctx& ctx) -> Stmt
 
     std::optional<std::shared_ptr<BinaryOpAstNode>> forCondition;
     std::optional<ExprNode> forUpdate;
-    if (stmt->cond) {
-        forCondition = translate_condition(translate(*stmt->cond, ctx), ctx);
-    }
-    if (stmt->inc) {
-        forUpdate = translate(*stmt->inc, ctx);
+    if (stmt.cond) {
+        forCondition = translate_condition(translate(*stmt.cond, ctx), ctx);
     }
-    if (stmt->body == nullptr) {
-        throw std::runtime_error("for body is null");
+    if (stmt.inc) {
+        forUpdate = translate(*stmt.inc, ctx);
     }
-    auto body = translate(*stmt->body.get(), ctx);
+    auto body = translate(stmt.body, ctx);
 
     return std::make_shared<ForLoopAstNode>(std::move(forInit), std::move(forCondition),
                                             std::move(forUpdate), std::move(body));
 }
 
-auto translate(const std::shared_ptr<st::FunctionCallExpression>& expr, Ctx& ctx) -> ExprNode {
+auto function_call(std::string_view name, std::vector<ExprNode> args) -> ExprNode {
+    const auto faux_return_type = DataType::int_type();
+
+    return std::make_shared<FunctionCallAstNode>(std::string(name), std::move(args),
+                                                 faux_return_type);
+}
+
+auto translate(const st::FunctionCallExpression& expr, Ctx& ctx) -> ExprNode {
     std::vector<ExprNode> args;
-    for (const auto& arg : expr->args) {
+    for (const auto arg : ctx.tree->list(expr.args)) {
         auto e = translate(arg, ctx);
         args.push_back(std::move(e));
     }
-
-    const auto faux_return_type = DataType::int_type();
-
-    return std::make_shared<FunctionCallAstNode>(expr->name, std::move(args), faux_return_type);
+    return function_call(expr.name, std::move(args));
 }
 
 // expression
 auto translate(const st::Expression& expr, Ctx& ctx) -> ExprNode {
     // TODO: fix. can lead to recursive call
-    return std::visit([&ctx](auto&& arg) { return translate(std::move(arg), ctx); }, expr);
+    return ctx.tree->visit([&ctx](const auto& node) { return translate(node, ctx); }, expr);
 }
 
 // return statement
-auto translate(const std::shared_ptr<st::ReturnStatement>& stmt, Ctx& ctx) -> Stmt {
+auto translate(const st::ReturnStatement& stmt, Ctx& ctx) -> Stmt {
     ctx.set_lvalueContext("translate(const st::ReturnStatement &stmt, Ctx &ctx)", false);
-    auto expr = translate(stmt->expr, ctx);
+    auto expr = translate(stmt.expr, ctx);
     ctx.set_lvalueContext("translate(const st::ReturnStatement &stmt, Ctx &ctx)", true);
     return std::make_shared<ReturnAstNode>(std::move(expr));
 }
 
-// expression statement
-auto translate(const std::shared_ptr<st::ExpressionStatement>& stmt, Ctx& ctx) -> Stmt {
-    const auto expression = translate(stmt->expr, ctx);
+auto expression_statement(const ExprNode& expression) -> Stmt {
     const auto node = expression.node;
     return std::visit([&node](auto&& arg) { return Stmt{std::move(arg)}; }, node);
 }
 
+// expression statement
+auto translate(const st::ExpressionStatement& stmt, Ctx& ctx) -> Stmt {
+    return expression_statement(translate(stmt.expr, ctx));
+}
+
 // selection statement statement
-auto translate(const std::shared_ptr<st::SelectionStatement>& stmt, Ctx& ctx) -> Stmt {
-    auto condition = translate(stmt->cond, ctx);
+auto translate(const st::SelectionStatement& stmt, Ctx& ctx) -> Stmt {
+    auto condition = translate(stmt.cond, ctx);
     auto translatedCondition = translate_condition(condition, ctx);
-    auto then = translate(*stmt->then, ctx);
+    auto then = translate(stmt.then, ctx);
     std::optional<std::vector<BodyNode>> else_ = std::nullopt;
-    if (stmt->else_) {
-        else_ = translate(*stmt->else_, ctx);
+    if (stmt.else_) {
+        else_ = translate(*stmt.else_, ctx);
     }
     return std::make_shared<IfNode>(std::move(translatedCondition), std::move(then),
                                     std::move(else_));
 }
 
+auto declare_variable(const st::Declaration& decl, Ctx& ctx)
+    -> std::shared_ptr<VariableAstNode> {
+    const auto iden = decl.initDeclarator.value().declarator.directDeclarator.VariableIden();
+    auto datatype = ast::toDataType(*ctx.tree, decl);
+    auto var = std::make_shared<VariableAstNode>(iden, datatype);
+    ctx.local_variables[iden] = var;
+    return var;
+}
+
 // declaration
 [[nodiscard]] auto translate(const st::Declaration& decl, Ctx& ctx)
     -> std::shared_ptr<MoveAstNode> {
-    const auto iden = decl.initDeclarator.value().declarator.directDeclarator.VariableIden();
-    auto datatype = ast::toDataType(decl);
-    const auto var = std::make_shared<VariableAstNode>(iden, datatype);
-    ctx.local_variables[iden] = var;
+    const auto var = declare_variable(decl, ctx);
 
     if (!decl.initDeclarator.value().initializer.has_value()) {
-        return std::make_shared<MoveAstNode>(std::make_shared<VariableAstNode>(iden, datatype),
-                                             std::nullopt);
+        return std::make_shared<MoveAstNode>(
+            std::make_shared<VariableAstNode>(var->name, var->type), std::nullopt);
     }
 
     const auto& expr = decl.initDeclarator.value().initializer.value().expr;
@@ -225,11 +289,11 @@ auto translate(const std::shared_ptr<st::SelectionStatement>& stmt, Ctx& ctx) ->
     return std::make_shared<MoveAstNode>(std::move(var), std::move(init));
 }
 
-[[nodiscard]] std::vector<FrameParam> translate(st::ParamTypeList& params) {
+[[nodiscard]] std::vector<FrameParam> translate(const st::ParamTypeList& params, Ctx& ctx) {
     std::vector<FrameParam> result;
-    for (const auto& p : params.params) {
+    for (const auto& p : ctx.tree->list(params.params)) {
         const auto name = p.Name();
-        const auto type = ast::toDataType(p);
+        const auto type = ast::toDataType(*ctx.tree, p);
         const auto fp = FrameParam{
             .name = name,
             .type = type,
@@ -239,23 +303,22 @@ auto translate(const std::shared_ptr<st::SelectionStatement>& stmt, Ctx& ctx) ->
     return result;
 }
 
-auto translateStatement(st::Statement& stmt, Ctx& ctx) -> Stmt {
-    auto s = std::move(stmt.stmt);
-    return std::visit([&ctx](auto&& arg) { return translate(std::move(arg), ctx); }, s);
+auto translateStatement(const st::Statement& stmt, Ctx& ctx) -> Stmt {
+    return ctx.tree->visit([&ctx](const auto& node) { return translate(node, ctx); }, stmt);
 }
 
-auto translate(st::CompoundStatement& stmts, Ctx& ctx) -> std::vector<BodyNode> {
-    if (stmts.items.empty()) {
+auto translate(const st::CompoundStatement& stmts, Ctx& ctx) -> std::vector<BodyNode> {
+    if (stmts.items.count == 0) {
         return {};
     }
     std::vector<BodyNode> result;
-    for (auto& bi : stmts.items) {
+    for (const auto& bi : ctx.tree->list(stmts.items)) {
         if (std::holds_alternative<st::Statement>(bi.item)) {
-            auto stmt = std::get<st::Statement>(std::move(bi.item));
+            const auto stmt = std::get<st::Statement>(bi.item);
             auto node = translateStatement(stmt, ctx);
             result.push_back(std::move(node));
         } else {
-            auto& decl = std::get<st::Declaration>(bi.item);
+            const auto& decl = std::get<st::Declaration>(bi.item);
             auto node = translate(decl, ctx);
             result.push_back(std::move(node));
         }
@@ -263,24 +326,28 @@ auto translate(st::CompoundStatement& stmts, Ctx& ctx) -> std::vector<BodyNode>
     return result;
 }
 
-auto translate(st::FuncDef* fd, Ctx& ctx) -> std::shared_ptr<FrameAstNode> {
-    const auto functionName = fd->Name();
-    auto functionParams = fd->DirectDeclarator().params;
-    auto params = translate(functionParams);
+auto declare_parameters(const st::FuncDef& fd, Ctx& ctx) -> std::vector<FrameParam> {
+    const auto functionParams = fd.DirectDeclarator().params;
+    auto params = translate(functionParams, ctx);
     for (const auto& p : params) {
         const auto paramName = p.name;
         const auto type = p.type;
         ctx.local_variables[p.name] = std::make_shared<VariableAstNode>(paramName, type);
     }
-    auto body = translate(fd->body, ctx);
+    return params;
+}
+
+auto translate(const st::FuncDef& fd, Ctx& ctx) -> std::shared_ptr<FrameAstNode> {
+    const auto functionName = fd.Name();
+    auto params = declare_parameters(fd, ctx);
+    auto body = translate(fd.body, ctx);
     return std::make_shared<FrameAstNode>(functionName, std::move(body), std::move(params));
 }
 
 auto translate(const st::ExternalDeclaration& node, Ctx& ctx) -> TopLevelNode {
     const auto& nv = node.node;
-    if (std::holds_alternative<std::shared_ptr<st::FuncDef>>(nv)) {
-        auto funcdef = std::get<std::shared_ptr<st::FuncDef>>(nv).get();
-        return TopLevelNode{translate(funcdef, ctx)};
+    if (std::holds_alternative<st::FuncDef>(nv)) {
+        return TopLevelNode{translate(std::get<st::FuncDef>(nv), ctx)};
     }
     const auto& decl = std::get<st::Declaration>(nv);
 
@@ -289,6 +356,7 @@ auto translate(const st::ExternalDeclaration& node, Ctx& ctx) -> TopLevelNode {
 
 [[nodiscard]] std::vector<TopLevelNode> translate(const st::Program& program) {
     auto ctx = Ctx{
+        .tree = &program.tree,
         .counter = 0,
         .local_variables = {},
     };
@@ -299,4 +367,108 @@ auto translate(const st::ExternalDeclaration& node, Ctx& ctx) -> TopLevelNode {
     }
     return nodes;
 }
+
+namespace {
+
+// registers what translating `stmts` would, in the same order, without translating them
+void declare_all(const st::CompoundStatement& stmts, Ctx& ctx) {
+    for (const auto& bi : ctx.tree->list(stmts.items)) {
+        if (std::holds_alternative<st::Declaration>(bi.item)) {
+            (void)declare_variable(std::get<st::Declaration>(bi.item), ctx);
+            continue;
+        }
+        const auto stmt = std::get<st::Statement>(bi.item);
+        if (stmt.kind == st::StatementKind::FOR) {
+            const auto& loop = ctx.tree->get<st::ForStatement>(stmt);
+            (void)declare_loop_variable(loop.init, ctx);
+            declare_all(loop.body, ctx);
+        } else if (stmt.kind == st::StatementKind::SELECTION) {
+            const auto& selection = ctx.tree->get<st::SelectionStatement>(stmt);
+            declare_all(selection.then, ctx);
+            if (selection.else_) {
+                declare_all(*selection.else_, ctx);
+            }
+        }
+    }
+}
+
+void declare_all(const st::ExternalDeclaration& node, Ctx& ctx) {
+    if (const auto* fd = std::get_if<st::FuncDef>(&node.node)) {
+        (void)declare_parameters(*fd, ctx);
+        declare_all(fd->body, ctx);
+    } else {
+        (void)declare_variable(std::get<st::Declaration>(node.node), ctx);
+    }
+}
+
+struct TranslatedPart {
+    std::vector<TopLevelNode> nodes = {};
+    // the lvalue context the part was translated from and what it left, see Ctx::lvalueContext()
+    bool lvalue_context = false;
+    bool lvalue_context_left = false;
+    bool lvalue_context_set = false;
+    bool lvalue_context_inherited = false;
+};
+
+[[nodiscard]] auto translate_part(std::span<const st::Program> parts, std::size_t part,
+                                  const DeclarationHistory& history, bool lvalue_context)
+    -> TranslatedPart {
+    auto ctx = Ctx{
+        .tree = &parts[part].tree,
+        .counter = 0,
+        .__lvalueContext = lvalue_context,
+        .local_variables = {},
+        .earlier_parts = &history,
+        .part = part,
+    };
+    TranslatedPart result{.lvalue_context = lvalue_context};
+    result.nodes.reserve(parts[part].nodes.size());
+    for (const auto& decl : parts[part].nodes) {
+        result.nodes.push_back(translate(decl, ctx));
+    }
+    result.lvalue_context_left = ctx.__lvalueContext;
+    result.lvalue_context_set = ctx.lvalue_context_set;
+    result.lvalue_context_inherited = ctx.lvalue_context_inherited;
+    return result;
+}
+
+}  // namespace
+
+auto translate_parts(std::span<const st::Program> parts, support::ThreadPool& pool)
+    -> std::vector<TopLevelNode> {
+    std::vector<Variables> declared(parts.size());
+    pool.parallel_for(parts.size(), [&](std::size_t part) {
+        auto ctx = Ctx{.tree = &parts[part].tree, .counter = 0, .local_variables = {}};
+        for (const auto& decl : parts[part].nodes) {
+            declare_all(decl, ctx);
+        }
+        declared[part] = std::move(ctx.local_variables);
+    });
+    DeclarationHistory history;
+    for (std::size_t part = 0; part < parts.size(); ++part) {
+        history.add(part, declared[part]);
+    }
+
+    // Nearly every function ends on a return or an initialized declaration, which leave the
+    // context true, so that is the guess for all but the first part.
+    std::vector<std::optional<TranslatedPart>> translated(parts.size());
+    pool.parallel_for(parts.size(), [&](std::size_t part) {
+        translated[part] = translate_part(parts, part, history, part > 0);
+    });
+
+    std::vector<TopLevelNode> nodes;
+    bool lvalue_context = false;
+    for (std::size_t part = 0; part < parts.size(); ++part) {
+        auto& result = *translated[part];
+        if (result.lvalue_context_inherited && result.lvalue_context != lvalue_context) {
+            result = translate_part(parts, part, history, lvalue_context);
+        }
+        if (result.lvalue_context_set) {
+            lvalue_context = result.lvalue_context_left;
+        }
+        std::move(result.nodes.begin(), result.nodes.end(), std::back_inserter(nodes));
+    }
+    return nodes;
+}
+
 }  // namespace ast
@@ -1,7 +1,15 @@
+#include "../include/driver.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 
+#include "../include/compile_cache.hpp"
+#include "../include/compiler/ast_builder.hpp"
 #include "../include/compiler/qa_ir/assem.hpp"
 #include "../include/compiler/qa_ir/optpass.hpp"
 #include "../include/compiler/target/allocator.hpp"
@@ -10,62 +18,103 @@
 #include "../include/compiler/translate.hpp"
 #include "../include/lexer/lexer.hpp"
 #include "../include/parser/parser.hpp"
+#include "../include/support/source_buffer.hpp"
+#include "../include/support/thread_pool.hpp"
+#include "../include/support/time_report.hpp"
+
+namespace {
+
+constexpr std::size_t dump_buffer_size = 1 << 16;
+
+[[nodiscard]] auto dump_stage_name(DumpStage stage) -> std::string_view {
+    switch (stage) {
+        case DumpStage::ST:
+            return "st";
+        case DumpStage::AST:
+            return "ast";
+        case DumpStage::IR:
+            return "ir";
+        case DumpStage::OPT_IR:
+            return "opt-ir";
+        case DumpStage::TARGET_IR:
+            return "target-ir";
+    }
+    return "unknown";
+}
+
+// An output file with a large user supplied buffer, so dumping a big translation unit is a
+// handful of write(2) calls rather than one per line.
+class DumpFile {
+   public:
+    explicit DumpFile(const std::string& path) : buffer(dump_buffer_size), stream() {
+        stream.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        stream.open(path);
+        if (!stream.is_open()) {
+            throw std::runtime_error("could not open dump file " + path);
+        }
+    }
 
-#define DEBUG 1
+    [[nodiscard]] auto out() -> std::ostream& { return stream; }
 
-[[nodiscard]] const std::string readfile(const char* sourcefile) {
-    std::ifstream inFile;
-    inFile.open(sourcefile);
-    std::stringstream strStream;
-    strStream << inFile.rdbuf();
-    return strStream.str();
+   private:
+    // declared before the stream so it outlives it
+    std::vector<char> buffer;
+    std::ofstream stream;
+};
+
+template <typename Printer>
+void dump(const DriverOptions& options, DumpStage stage, const std::string& outfile,
+          Printer&& printer) {
+    if (!options.dumps.contains(stage)) {
+        return;
+    }
+    DumpFile file(outfile + "." + std::string(dump_stage_name(stage)));
+    printer(file.out());
 }
 
-void print_syntax_tree(const st::Program& st) {
-    std::cout << "-----------------" << std::endl;
-    std::cout << "Syntax Tree:" << std::endl;
+void print_syntax_tree(std::ostream& os, const st::Program& st) {
     for (const auto& node : st.nodes) {
-        std::cout << node << std::endl;
+        st::print(os, st.tree, node) << '\n';
     }
-    std::cout << "-----------------" << std::endl;
 }
 
-void print_ast(const std::vector<ast::TopLevelNode>& ast) {
-    std::cout << "-----------------" << std::endl;
-    std::cout << "AST:" << std::endl;
+void print_ast(std::ostream& os, const std::vector<ast::TopLevelNode>& ast) {
     for (const auto& node : ast) {
-        std::cout << node.toString() << std::endl;
+        node.print(os) << '\n';
     }
-    std::cout << "-----------------" << std::endl;
 }
 
-void print_ir(const std::vector<qa_ir::Frame>& frames) {
-    std::cout << "-----------------" << std::endl;
-    std::cout << "IR:" << std::endl;
+void print_ir(std::ostream& os, const std::vector<qa_ir::Frame>& frames) {
     for (const auto& frame : frames) {
-        std::cout << "Function: " << frame.name << std::endl;
+        os << "Function: " << frame.name << '\n';
         for (const auto& ins : frame.instructions) {
-            std::cout << ins << std::endl;
+            os << ins << '\n';
         }
-        std::cout << "-----------------" << std::endl;
+        os << "-----------------\n";
+    }
+}
+
+template <typename Frames>
+[[nodiscard]] auto count_instructions(const Frames& frames) -> std::size_t {
+    std::size_t count = 0;
+    for (const auto& frame : frames) {
+        count += frame.instructions.size();
     }
-    std::cout << "-----------------" << std::endl;
+    return count;
 }
 
-void print_target_ir(const std::vector<target::Frame>& frames) {
-    std::cout << "-----------------" << std::endl;
-    std::cout << "TARGET IR:" << std::endl;
+void print_target_ir(std::ostream& os, const std::vector<target::Frame>& frames) {
     for (const auto& frame : frames) {
-        std::cout << "Function: " << frame.name << std::endl;
+        os << "Function: " << frame.name << '\n';
         for (const auto& ins : frame.instructions) {
-            std::cout << std::visit([](const auto& arg) { return arg.debug_str(); }, ins)
-                      << std::endl;
+            os << std::visit([](const auto& arg) { return arg.debug_str(); }, ins) << '\n';
         }
-        std::cout << "-----------------" << std::endl;
+        os << "-----------------\n";
     }
-    std::cout << "-----------------" << std::endl;
 }
 
+}  // namespace
+
 void write_to_file(const std::string& code, const std::string& outfile) {
     std::ofstream outFile;
     outFile.open(outfile);
@@ -73,31 +122,464 @@ void write_to_file(const std::string& code, const std::string& outfile) {
     outFile.close();
 }
 
-int runfile(const char* sourcefile, const std::string& outfile) {
-    const auto contents = readfile(sourcefile);
-    const auto tokens = lexer::lex(contents);
-    const auto st = parse(tokens);
-
-    if (DEBUG) print_syntax_tree(st);
+auto parse_dump_stages(std::string_view list) -> std::optional<std::set<DumpStage>> {
+    constexpr DumpStage all_stages[] = {DumpStage::ST, DumpStage::AST, DumpStage::IR,
+                                        DumpStage::OPT_IR, DumpStage::TARGET_IR};
+    std::set<DumpStage> stages;
+    while (!list.empty()) {
+        const auto comma = list.find(',');
+        const auto name = list.substr(0, comma);
+        bool found = false;
+        for (const auto stage : all_stages) {
+            if (dump_stage_name(stage) == name) {
+                stages.insert(stage);
+                found = true;
+            }
+        }
+        if (!found) {
+            return std::nullopt;
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        list.remove_prefix(comma + 1);
+    }
+    return stages;
+}
 
-    auto ast = ast::translate(st);
+namespace {
 
-    if (DEBUG) print_ast(ast);
+struct FileResult {
+    int status = EXIT_SUCCESS;
+    // everything the compile would print to stderr
+    std::string diagnostics = "";
+    std::string json_report = "";
+};
 
+[[nodiscard]] auto run_backend(std::vector<ast::TopLevelNode>& ast, const std::string& outfile,
+                               const DriverOptions& options, support::TimeReport& report)
+    -> std::string {
+    auto timer = report.start("ir");
     auto frames = qa_ir::Produce_IR(ast);
+    timer.finish("ir ops", [&frames] { return count_instructions(frames); });
+    dump(options, DumpStage::IR, outfile, [&frames](auto& os) { print_ir(os, frames); });
 
-    if (DEBUG) print_ir(frames);
-
+    timer = report.start("opt");
     auto optimized_frames = qa_ir::move_from_temp_dest_pass(frames);
-    if (DEBUG) print_ir(optimized_frames);
+    timer.finish("ir ops", [&optimized_frames] { return count_instructions(optimized_frames); });
+    dump(options, DumpStage::OPT_IR, outfile,
+         [&optimized_frames](auto& os) { print_ir(os, optimized_frames); });
 
+    timer = report.start("lower");
     const auto lowered_frames = target::LowerIR(optimized_frames);
-    if (DEBUG) print_target_ir(lowered_frames);
+    timer.finish("x86 instructions",
+                 [&lowered_frames] { return count_instructions(lowered_frames); });
+    dump(options, DumpStage::TARGET_IR, outfile,
+         [&lowered_frames](auto& os) { print_target_ir(os, lowered_frames); });
 
+    timer = report.start("regalloc");
     const auto rewritten = target::rewrite(lowered_frames);
+    timer.finish("x86 instructions", [&rewritten] { return count_instructions(rewritten); });
+
+    timer = report.start("codegen");
+    auto code = target::Generate(rewritten);
+    timer.finish("asm bytes", [&code] { return code.size(); });
+    return code;
+}
+
+// a function's data section length, a newline, then its data and code sections
+[[nodiscard]] auto to_cache_entry(const target::FrameAsm& frame) -> std::string {
+    return std::to_string(frame.data.size()) + "\n" + frame.data + frame.code;
+}
 
-    const auto code = target::Generate(rewritten);
+[[nodiscard]] auto from_cache_entry(const std::string& entry) -> std::optional<target::FrameAsm> {
+    const auto newline = entry.find('\n');
+    if (newline == std::string::npos) {
+        return std::nullopt;
+    }
+    // a damaged entry is a miss
+    std::size_t data_size = 0;
+    const auto* first = entry.data();
+    const auto [end, ec] = std::from_chars(first, first + newline, data_size);
+    if (ec != std::errc() || end != first + newline || data_size > entry.size() - newline - 1) {
+        return std::nullopt;
+    }
+    return target::FrameAsm{.data = entry.substr(newline + 1, data_size),
+                            .code = entry.substr(newline + 1 + data_size)};
+}
+
+// Every function goes through IR generation, lowering, register allocation and emission as one
+// task on the pool. The per function assembly is joined in source order, so the output is the
+// same as run_backend(). Intermediate frames are only kept when they are dumped. With a cache,
+// functions whose fingerprint is unchanged are spliced back from it and skip the back end.
+[[nodiscard]] auto run_backend_per_function(std::vector<ast::TopLevelNode>& ast,
+                                            const std::string& outfile,
+                                            const DriverOptions& options,
+                                            support::TimeReport& report,
+                                            support::ThreadPool& pool, const CompileCache* cache)
+    -> std::string {
+    const bool keep_ir = options.dumps.contains(DumpStage::IR);
+    const bool keep_opt_ir = options.dumps.contains(DumpStage::OPT_IR);
+    const bool keep_target_ir = options.dumps.contains(DumpStage::TARGET_IR);
+    std::vector<qa_ir::Frame> frames(keep_ir ? ast.size() : 0);
+    std::vector<qa_ir::Frame> optimized_frames(keep_opt_ir ? ast.size() : 0);
+    std::vector<target::Frame> lowered_frames(keep_target_ir ? ast.size() : 0);
+    std::vector<target::FrameAsm> frame_code(ast.size());
+
+    std::atomic<std::size_t> cache_hits = 0;
+    std::atomic<std::size_t> cache_misses = 0;
+    std::atomic<std::size_t> cache_store_failures = 0;
+
+    auto timer = report.start("backend", support::CpuClock::Process);
+    pool.parallel_for(ast.size(), [&](std::size_t i) {
+        std::string key = "";
+        if (cache != nullptr && ast[i].is_function()) {
+            key = cache->key("function", ast::fingerprint(*ast[i].get_function()));
+            if (const auto entry = cache->load(key); entry.has_value()) {
+                if (auto cached = from_cache_entry(entry.value()); cached.has_value()) {
+                    frame_code[i] = std::move(cached.value());
+                    cache_hits++;
+                    return;
+                }
+            }
+            cache_misses++;
+        }
+
+        auto frame = qa_ir::Produce_IR(ast[i]);
+        auto optimized = qa_ir::move_from_temp_dest_pass(frame);
+        auto lowered = target::LowerIR(optimized);
+        frame_code[i] = target::GenerateFrame(target::rewrite(lowered));
+        if (!key.empty() && !cache->store(key, to_cache_entry(frame_code[i]))) {
+            cache_store_failures++;
+        }
+        if (keep_ir) {
+            frames[i] = std::move(frame);
+        }
+        if (keep_opt_ir) {
+            optimized_frames[i] = std::move(optimized);
+        }
+        if (keep_target_ir) {
+            lowered_frames[i] = std::move(lowered);
+        }
+    });
+    auto code = target::EmitProgram(frame_code);
+    timer.finish("functions", [&ast] { return ast.size(); });
+    if (cache != nullptr) {
+        report.count("function cache hits", cache_hits);
+        report.count("function cache misses", cache_misses);
+        if (cache_store_failures > 0) {
+            report.count("function cache store failures", cache_store_failures);
+        }
+    }
+
+    dump(options, DumpStage::IR, outfile, [&frames](auto& os) { print_ir(os, frames); });
+    dump(options, DumpStage::OPT_IR, outfile,
+         [&optimized_frames](auto& os) { print_ir(os, optimized_frames); });
+    dump(options, DumpStage::TARGET_IR, outfile,
+         [&lowered_frames](auto& os) { print_target_ir(os, lowered_frames); });
+    return code;
+}
+
+// The two pass front end: parse into a syntax tree, then translate that.
+[[nodiscard]] auto parse_and_translate(std::string_view source, std::span<const Token> tokens,
+                                       bool lexed, const DriverOptions& options,
+                                       const std::string& dump_prefix, support::TimeReport& report)
+    -> std::vector<ast::TopLevelNode> {
+    // unless lexed, the parser pulls tokens as it goes, so lexing is part of this phase
+    auto timer = report.start("parse");
+    auto parser = lexed ? Parser(tokens, source) : Parser(source);
+    const auto st = parser.parseProgram();
+    timer.finish("st nodes", [&st] { return st::count_nodes(st); });
+    if (!lexed) {
+        report.count("tokens", parser.tokens().position());
+    }
+    dump(options, DumpStage::ST, dump_prefix, [&st](auto& os) { print_syntax_tree(os, st); });
+
+    timer = report.start("translate");
+    auto ast = ast::translate(st);
+    timer.finish("ast nodes", [&ast] { return ast::count_nodes(ast); });
+    return ast;
+}
+
+// The single pass front end, see ast::AstBuilder. Input it does not reproduce the two pass
+// result for, ast::NotReproducible, yields nullopt and goes through the two passes. So does
+// invalid input, which both front ends report as std::runtime_error, so that diagnostics come in
+// the two pass order. Anything else is a bug and propagates.
+[[nodiscard]] auto parse_to_ast(std::string_view source, std::span<const Token> tokens,
+                                bool lexed, support::TimeReport& report)
+    -> std::optional<std::vector<ast::TopLevelNode>> {
+    auto timer = report.start("parse");
+    try {
+        auto parser = lexed ? ast::AstParser(tokens, source) : ast::AstParser(source);
+        auto ast = parser.parseProgram();
+        timer.finish("ast nodes", [&ast] { return ast::count_nodes(ast); });
+        if (!lexed) {
+            report.count("tokens", parser.tokens().position());
+        }
+        return ast;
+    } catch (const std::runtime_error&) {
+        timer.finish("", [] { return 0; });
+        report.count("fused front end fallbacks");
+        return std::nullopt;
+    }
+}
+
+// The outline of a program cut into about `parts` runs of external declarations with similar
+// token counts.
+[[nodiscard]] auto split_outline(std::span<const TokenRange> outline, std::size_t parts)
+    -> std::vector<std::span<const TokenRange>> {
+    std::vector<std::span<const TokenRange>> chunks;
+    if (outline.empty()) {
+        return chunks;
+    }
+    const auto tokens = outline.back().end - outline.front().begin;
+    const auto chunk_tokens = std::max<std::size_t>(tokens / parts, 1);
+    std::size_t first = 0;
+    for (std::size_t i = 0; i < outline.size(); ++i) {
+        if (i + 1 == outline.size() || outline[i].end - outline[first].begin >= chunk_tokens) {
+            chunks.push_back(outline.subspan(first, i + 1 - first));
+            first = i + 1;
+        }
+    }
+    return chunks;
+}
+
+// The parallel front end: function bodies are found by matching braces, then runs of external
+// declarations are parsed and translated on the pool, see ast::translate_parts(). Like
+// parse_to_ast(), an OutlineMismatch or invalid input yields nullopt and goes through the two
+// passes; anything else propagates.
+[[nodiscard]] auto parse_in_parts(std::string_view source, std::span<const Token> tokens,
+                                  support::TimeReport& report, support::ThreadPool& pool)
+    -> std::optional<std::vector<ast::TopLevelNode>> {
+    auto timer = report.start("outline");
+    try {
+        const auto outline = Parser(tokens, source).outlineProgram();
+        // a few per thread, so one long function does not hold up the rest
+        const auto chunks = split_outline(outline, pool.size() * 4);
+        timer.finish("external declarations", [&outline] { return outline.size(); });
+
+        timer = report.start("parse", support::CpuClock::Process);
+        std::vector<std::optional<st::Program>> parsed(chunks.size());
+        pool.parallel_for(chunks.size(), [&](std::size_t i) {
+            parsed[i] = Parser(tokens, source).parseExternalDeclarations(chunks[i]);
+        });
+        std::vector<st::Program> parts;
+        parts.reserve(parsed.size());
+        for (auto& part : parsed) {
+            parts.push_back(std::move(part.value()));
+        }
+        timer.finish("st nodes", [&parts] {
+            std::size_t nodes = 0;
+            for (const auto& part : parts) {
+                nodes += st::count_nodes(part);
+            }
+            return nodes;
+        });
+
+        timer = report.start("translate", support::CpuClock::Process);
+        auto ast = ast::translate_parts(parts, pool);
+        timer.finish("ast nodes", [&ast] { return ast::count_nodes(ast); });
+        return ast;
+    } catch (const std::runtime_error&) {
+        timer.finish("", [] { return 0; });
+        report.count("parallel front end fallbacks");
+        return std::nullopt;
+    }
+}
+
+}  // namespace
+
+auto compile_to_assembly(std::string_view source, const DriverOptions& options,
+                         const std::string& dump_prefix, support::TimeReport& report,
+                         support::ThreadPool& pool) -> std::string {
+    // big enough for lexing on every thread to beat overlapping lexing with parsing
+    const bool lex_in_parallel =
+        pool.size() > 1 && source.size() >= 2 * lexer::parallel_lex_min_chunk;
+    // the syntax tree dump needs the whole syntax tree, which neither of these builds
+    const bool in_parts = options.parallel_front_end && !options.dumps.contains(DumpStage::ST);
+    const bool fused = !in_parts && options.fused_front_end &&
+                       !options.dumps.contains(DumpStage::ST);
+    std::vector<Token> tokens;
+    bool lexed = false;
+    // The outline needs every token. Invalid input is left to the streaming parser, which
+    // reports whichever error comes first, whatever the number of threads.
+    if (lex_in_parallel || in_parts) {
+        try {
+            auto lex_timer = lex_in_parallel ? report.start("lex", support::CpuClock::Process)
+                                             : report.start("lex");
+            tokens = lex_in_parallel ? lexer::lex_parallel(source, pool) : lexer::lex(source);
+            lex_timer.finish("tokens", [&tokens] { return tokens.size(); });
+            lexed = true;
+        } catch (const std::runtime_error&) {
+        }
+    }
+
+    std::optional<std::vector<ast::TopLevelNode>> front_end = std::nullopt;
+    if (in_parts && lexed) {
+        front_end = parse_in_parts(source, tokens, report, pool);
+    } else if (fused) {
+        front_end = parse_to_ast(source, tokens, lexed, report);
+    }
+    auto ast = front_end.has_value()
+                   ? std::move(front_end.value())
+                   : parse_and_translate(source, tokens, lexed, options, dump_prefix, report);
+    dump(options, DumpStage::AST, dump_prefix, [&ast](auto& os) { print_ast(os, ast); });
+
+    // same rule as for the whole file cache in run_pipeline()
+    if (options.cache_dir.has_value() && options.dumps.empty()) {
+        const CompileCache cache(options.cache_dir.value(), options.cache_max_bytes);
+        return run_backend_per_function(ast, dump_prefix, options, report, pool, &cache);
+    }
+    return pool.size() > 1
+               ? run_backend_per_function(ast, dump_prefix, options, report, pool, nullptr)
+               : run_backend(ast, dump_prefix, options, report);
+}
+
+namespace {
+
+void run_pipeline(const char* sourcefile, const std::string& outfile, const DriverOptions& options,
+                  support::TimeReport& report, support::ThreadPool& pool) {
+    auto timer = report.start("read");
+    const auto source = support::SourceBuffer::open(sourcefile);
+    const auto contents = source.view();
+    timer.finish("bytes", [&contents] { return contents.size(); });
+
+    // dumps are side outputs of a real compile, so they bypass the cache
+    std::optional<CompileCache> cache = std::nullopt;
+    std::string key = "";
+    if (options.cache_dir.has_value() && options.dumps.empty()) {
+        timer = report.start("cache lookup");
+        cache.emplace(options.cache_dir.value(), options.cache_max_bytes);
+        key = cache->key("unit", contents);
+        const bool hit = cache->fetch(key, outfile);
+        timer.finish("", [] { return 0; });
+        report.count(hit ? "cache hits" : "cache misses");
+        if (hit) {
+            return;
+        }
+    }
+
+    const auto code = compile_to_assembly(contents, options, outfile, report, pool);
+
+    timer = report.start("write");
     write_to_file(code, outfile);
+    timer.finish("bytes", [&code] { return code.size(); });
+
+    if (cache.has_value()) {
+        timer = report.start("cache store");
+        if (!cache->store(key, code)) {
+            report.count("cache store failures");
+        }
+        cache->evict();
+        timer.finish("", [] { return 0; });
+    }
+}
+
+// Compiles one translation unit. Nothing is printed, diagnostics and reports are collected in
+// the result so that concurrent compiles can be reported in input order.
+[[nodiscard]] auto compile_file(const char* sourcefile, const std::string& outfile,
+                                const DriverOptions& options, support::ThreadPool& pool)
+    -> FileResult {
+    support::trace::Span file_span("runfile", sourcefile);
+    support::TimeReport report(options.time_report || options.time_report_json.has_value(),
+                               sourcefile);
+    FileResult result;
+    try {
+        run_pipeline(sourcefile, outfile, options, report, pool);
+    } catch (const std::exception& e) {
+        result.status = EXIT_FAILURE;
+        result.diagnostics = std::string(sourcefile) + ": error: " + e.what() + "\n";
+    }
+
+    if (options.time_report) {
+        std::ostringstream os;
+        report.print(os);
+        result.diagnostics += os.str();
+    }
+    if (options.time_report_json.has_value()) {
+        std::ostringstream os;
+        report.print_json(os);
+        result.json_report = os.str();
+    }
+    return result;
+}
+
+// false, after saying so on stderr, when the report could not be written
+[[nodiscard]] auto write_json_reports(const DriverOptions& options,
+                                      const std::vector<FileResult>& results, bool as_array)
+    -> bool {
+    if (!options.time_report_json.has_value()) {
+        return true;
+    }
+    const auto& path = options.time_report_json.value();
+    std::ofstream json(path);
+    if (!json.is_open()) {
+        std::cerr << path << ": error: could not open time report file\n";
+        return false;
+    }
+    json << (as_array ? "[" : "");
+    for (std::size_t i = 0; i < results.size(); i++) {
+        json << (i == 0 ? "" : ",\n") << results[i].json_report;
+    }
+    json << (as_array ? "]\n" : "\n");
+    json.close();
+    if (!json) {
+        std::cerr << path << ": error: could not write time report file\n";
+        return false;
+    }
+    return true;
+}
 
-    return 0;
+}  // namespace
+
+int runfile(const char* sourcefile, const std::string& outfile, const DriverOptions& options) {
+    support::ThreadPool pool(options.jobs);
+    const auto result = compile_file(sourcefile, outfile, options, pool);
+    std::cerr << result.diagnostics;
+    if (!write_json_reports(options, {result}, false)) {
+        return EXIT_FAILURE;
+    }
+    return result.status;
+}
+
+int runfiles(const std::vector<std::string>& sourcefiles, const std::string& outdir,
+             const DriverOptions& options) {
+    std::vector<std::string> outfiles;
+    std::set<std::string> seen;
+    for (const auto& sourcefile : sourcefiles) {
+        auto outfile = (std::filesystem::path(outdir) /
+                        std::filesystem::path(sourcefile).filename().replace_extension(".asm"))
+                           .string();
+        if (!seen.insert(outfile).second) {
+            std::cerr << sourcefile << ": error: output " << outfile
+                      << " would overwrite the output of another input\n";
+            return EXIT_FAILURE;
+        }
+        outfiles.push_back(std::move(outfile));
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(outdir, ec);
+    if (ec) {
+        std::cerr << outdir << ": error: " << ec.message() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<FileResult> results(sourcefiles.size());
+    support::ThreadPool pool(options.jobs);
+    pool.parallel_for(sourcefiles.size(), [&](std::size_t i) {
+        results[i] = compile_file(sourcefiles[i].c_str(), outfiles[i], options, pool);
+    });
+
+    int status = EXIT_SUCCESS;
+    for (const auto& result : results) {
+        std::cerr << result.diagnostics;
+        if (result.status != EXIT_SUCCESS) {
+            status = result.status;
+        }
+    }
+    if (!write_json_reports(options, results, true)) {
+        return EXIT_FAILURE;
+    }
+    return status;
 }
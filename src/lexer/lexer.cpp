@@ -1,147 +1,157 @@
 #include "../../include/lexer/lexer.hpp"
 
-#include <ctype.h>
-
 #include <cassert>
-#include <exception>
+#include <charconv>
+#include <cstdint>
+#include <limits>
 #include <optional>
-#include <unordered_map>
+#include <stdexcept>
+
+#include "../../include/lexer/keywords.hpp"
+#include "../../include/lexer/scan.hpp"
+#include "../../include/lexer/tables.hpp"
 
 namespace lexer {
 
-static unsigned long current = 0;
-static unsigned long start = 0;
-static unsigned long line = 1;
-std::string source;
+namespace {
+
+[[nodiscard]] constexpr auto is_digit(char c) -> bool { return char_class(c) == CharClass::DIGIT; }
+
+[[nodiscard]] constexpr auto is_identifier(char c) -> bool {
+    const auto cls = char_class(c);
+    return cls == CharClass::ALPHA || cls == CharClass::DIGIT || c == '_';
+}
 
-const std::unordered_map<std::string, TokType> keywords = {
-    {"return", TokType::TOKEN_RETURN},   {"int", TokType::TOKEN_T_INT},
-    {"else", TokType::TOKEN_ELSE},       {"if", TokType::TOKEN_IF},
-    {"for", TokType::TOKEN_FOR},         {"void", TokType::TOKEN_T_VOID},
-    {"double", TokType::TOKEN_T_DOUBLE}, {"float", TokType::TOKEN_T_FLOAT},
-};
+[[nodiscard]] constexpr auto is_blank(char c) -> bool { return char_class(c) == CharClass::BLANK; }
 
-auto isAtEnd() -> bool { return current >= source.size(); }
+[[nodiscard]] constexpr auto is_not_newline(char c) -> bool { return c != '\n'; }
 
-auto advance() -> char {
+}  // namespace
+
+Lexer::Lexer(std::string_view p_source) : Lexer(p_source, 0, p_source.size()) {}
+
+Lexer::Lexer(std::string_view p_source, std::size_t p_begin, std::size_t p_end)
+    : source(p_source.substr(0, p_end)),
+      scanner(&active_scanner()),
+      current(p_begin),
+      start(p_begin),
+      line_start(p_begin) {
+    if (p_source.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error("source files larger than 4 GiB are not supported");
+    }
+}
+
+// Moves `current` to the end of the run `scan` finds from it. Most runs in C are a byte or two
+// long, so the byte after the first is checked here before paying for the call.
+template <auto Continues>
+void Lexer::skip(decltype(Scanner::skip_blanks) scan) {
+    if (isAtEnd() || !Continues(source[current])) {
+        return;
+    }
+    const char* end = source.data() + source.size();
+    current = static_cast<unsigned long>(scan(source.data() + current, end) - source.data());
+}
+
+auto Lexer::advance() -> char {
     assert(!isAtEnd());
     return source[current++];
 }
 
-auto peek() -> char {
+auto Lexer::peek() const -> char {
     if (isAtEnd()) return '\0';
     return source[current];
 }
 
-[[nodiscard]] char peekNext() {
+auto Lexer::peekNext() const -> char {
     if (current + 1 >= source.size()) return '\0';
     return source[current + 1];
 }
 
-[[nodiscard]] std::optional<Token> scanToken() {
-    char c = advance();
-    switch (c) {
-        case '&':
-            return Token{TokType::TOKEN_AMPERSAND, "&"};
-        case '(':
-            return Token{TokType::TOKEN_LEFT_PAREN, "("};
-        case ')':
-            return Token{TokType::TOKEN_RIGHT_PAREN, ")"};
-        case '{':
-            return Token{TokType::TOKEN_LEFT_BRACE, "{"};
-        case '}':
-            return Token{TokType::TOKEN_RIGHT_BRACE, "}"};
-        case '[':
-            return Token{TokType::TOKEN_LEFT_BRACKET, "["};
-        case ']':
-            return Token{TokType::TOKEN_RIGHT_BRACKET, "]"};
-        case ',':
-            return Token{TokType::TOKEN_COMMA, ","};
-        case '.':
-            return Token{TokType::TOKEN_DOT, "."};
-        case '-':
-            return Token{TokType::TOKEN_MINUS, "-"};
-        case '+':
-            return Token{TokType::TOKEN_PLUS, "+"};
-        case ';':
-            return Token{TokType::TOKEN_SEMICOLON, ";"};
-        case '*':
-            return Token{TokType::TOKEN_STAR, "*"};
-        case '!':
-            if (peek() == '=') {
-                advance();
-                return Token{TokType::TOKEN_BANG_EQUAL, "!="};
-            }
-            return Token{TokType::TOKEN_BANG, "!"};
-        case '=':
-            if (peek() == '=') {
-                advance();
-                return Token{TokType::TOKEN_EQUAL_EQUAL, "=="};
-            }
-            return Token{TokType::TOKEN_EQUAL, "="};
-        case '<':
-            if (peek() == '=') {
-                advance();
-                return Token{TokType::TOKEN_LESS_EQUAL, "<="};
-            }
-            return Token{TokType::TOKEN_LESS, "<"};
-        case '>':
-            if (peek() == '=') {
-                advance();
-                return Token{TokType::TOKEN_GREATER_EQUAL, ">="};
-            }
-            return Token{TokType::TOKEN_GREATER, ">"};
-        case '/':
-            if (peek() == '/') {
-                while (peek() != '\n' && !isAtEnd()) {
-                    advance();
-                }
-            } else {
-                return Token{TokType::TOKEN_SLASH, "/"};
-            }
-        case ' ':
-        case '\r':
-        case '\t':
-        case '\0':
-            break;
-        case '\n':
+// the token spanning [start, current)
+auto Lexer::make_token(TokType type) const -> Token {
+    Token tk = {};
+    tk.type = type;
+    tk.offset = static_cast<std::uint32_t>(start);
+    tk.length = static_cast<std::uint32_t>(current - start);
+    tk.line = static_cast<std::uint32_t>(line);
+    tk.column = static_cast<std::uint32_t>(start - line_start + 1);
+    return tk;
+}
+
+// a number literal starting at `start`, whose first digit was consumed
+auto Lexer::number() -> Token {
+    skip<is_digit>(scanner->digits_end);
+    const bool is_float = peek() == '.' && is_digit(peekNext());
+    if (is_float) {
+        advance();
+        skip<is_digit>(scanner->digits_end);
+    }
+    const char* first = source.data() + start;
+    const char* last = source.data() + current;
+    auto tk = make_token(is_float ? TokType::TOKEN_FLOAT_NUMBER : TokType::TOKEN_NUMBER);
+    const auto result = is_float ? std::from_chars(first, last, tk.float_value)
+                                 : std::from_chars(first, last, tk.int_value);
+    if (result.ec != std::errc{}) {
+        throw std::runtime_error("Number " + std::string(first, last) +
+                                 " is out of range on line " + std::to_string(line));
+    }
+    return tk;
+}
+
+auto Lexer::scanToken() -> std::optional<Token> {
+    const char c = advance();
+    switch (char_class(c)) {
+        case CharClass::BLANK:
+            skip<is_blank>(scanner->skip_blanks);
+            return std::nullopt;
+        case CharClass::NEWLINE:
             line++;
-            break;
-        default:
-            if (isdigit(c)) {
-                while (isdigit(peek())) advance();
-                if (peek() == '.' && isdigit(peekNext())) {
-                    advance();
-                    while (isdigit(peek())) advance();
-                }
-                return Token{TokType::TOKEN_NUMBER, source.substr(start, current - start)};
-            } else if (isalpha(c)) {
-                while (isalnum(peek()) || peek() == '_') {
-                    advance();
-                }
-                assert(current - 1 < source.size());
-                const std::string text = source.substr(start, current - start);
-                if (keywords.find(text) != keywords.end()) {
-                    return Token{keywords.at(text), text};
-                }
-                return Token{TokType::TOKEN_IDENTIFIER, text};
-            } else {
-                fprintf(stderr, "Unexpected character '%d' on line %zu\n", c, line);
-                exit(EXIT_FAILURE);
+            line_start = current;
+            return std::nullopt;
+        case CharClass::NUL:
+            return std::nullopt;
+        case CharClass::DIGIT:
+            return number();
+        case CharClass::ALPHA:
+            skip<is_identifier>(scanner->identifier_end);
+            return make_token(keyword_type(source.substr(start, current - start)));
+        case CharClass::OPERATOR: {
+            if (c == '/' && peek() == '/') {
+                skip<is_not_newline>(scanner->find_newline);
+                return std::nullopt;
             }
+            const auto match = match_operator(source.substr(start));
+            current = start + match.length;
+            return make_token(match.type);
+        }
+        case CharClass::INVALID:
+            break;
     }
-    return std::nullopt;
+    throw std::runtime_error("Unexpected character '" + std::string(1, c) + "' on line " +
+                             std::to_string(line));
 }
 
-[[nodiscard]] std::vector<Token> lex(const std::string& src) {
-    source = src;
-    std::vector<Token> tokens;
+auto Lexer::next() -> Token {
     while (!isAtEnd()) {
-        const auto tk = scanToken();
-        if (tk.has_value()) tokens.push_back(tk.value());
         start = current;
+        const auto tk = scanToken();
+        if (tk.has_value()) {
+            return tk.value();
+        }
     }
-    tokens.push_back(Token{TokType::TOKEN_FEOF, ""});
+    start = current;
+    return make_token(TokType::TOKEN_FEOF);
+}
+
+auto lex(std::string_view source) -> std::vector<Token> {
+    Lexer lexer(source);
+    std::vector<Token> tokens;
+    // C averages a token every three to five bytes; capacity that is never written is never
+    // faulted in, so reserving generously costs address space rather than memory
+    tokens.reserve(source.size() / 2 + 1);
+    do {
+        tokens.push_back(lexer.next());
+    } while (tokens.back().type != TokType::TOKEN_FEOF);
     return tokens;
 }
-}  // namespace lexer
\ No newline at end of file
+}  // namespace lexer
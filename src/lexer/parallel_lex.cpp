@@ -0,0 +1,90 @@
+#include "../../include/lexer/lexer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "../../include/support/thread_pool.hpp"
+
+namespace lexer {
+
+namespace {
+
+// Chunk boundaries: 0, the starts of the chunks and the end of the buffer. Every chunk starts at
+// a line. No token spans a newline and // comments end at one, so the lexer is in its initial
+// state at the start of every line.
+[[nodiscard]] auto chunk_boundaries(std::string_view source, std::size_t chunks)
+    -> std::vector<std::size_t> {
+    std::vector<std::size_t> boundaries = {0};
+    for (std::size_t i = 1; i < chunks; i++) {
+        const auto target = std::max(source.size() / chunks * i, boundaries.back());
+        const void* newline = std::memchr(source.data() + target, '\n', source.size() - target);
+        if (newline == nullptr) {
+            break;
+        }
+        const auto boundary =
+            static_cast<std::size_t>(static_cast<const char*>(newline) - source.data()) + 1;
+        if (boundary > boundaries.back() && boundary < source.size()) {
+            boundaries.push_back(boundary);
+        }
+    }
+    boundaries.push_back(source.size());
+    return boundaries;
+}
+
+}  // namespace
+
+auto lex_parallel(std::string_view source, support::ThreadPool& pool) -> std::vector<Token> {
+    const auto chunks = std::min(pool.size(), source.size() / parallel_lex_min_chunk);
+    const auto boundaries = chunk_boundaries(source, chunks);
+    const auto count = boundaries.size() - 1;
+    if (count <= 1) {
+        return lex(source);
+    }
+
+    // lines are counted from each chunk's start and shifted once all chunks are done
+    std::vector<std::vector<Token>> parts(count);
+    std::vector<unsigned long> newlines(count);
+    try {
+        pool.parallel_for(count, [&](std::size_t i) {
+            Lexer lexer(source, boundaries[i], boundaries[i + 1]);
+            auto& tokens = parts[i];
+            tokens.reserve((boundaries[i + 1] - boundaries[i]) / 2 + 1);
+            do {
+                tokens.push_back(lexer.next());
+            } while (tokens.back().type != TokType::TOKEN_FEOF);
+            // only the end of the buffer ends the token stream
+            if (i + 1 < count) {
+                tokens.pop_back();
+            }
+            newlines[i] = lexer.line_number() - 1;
+        });
+    } catch (const std::runtime_error&) {
+        // a chunk cannot tell the line its error is on; lexing serially reports the first error
+        // in the file exactly as lex() does
+        return lex(source);
+    }
+
+    std::vector<std::size_t> first_token(count + 1, 0);
+    std::vector<std::uint32_t> first_line(count, 0);
+    for (std::size_t i = 0; i < count; i++) {
+        first_token[i + 1] = first_token[i] + parts[i].size();
+        if (i + 1 < count) {
+            first_line[i + 1] = static_cast<std::uint32_t>(first_line[i] + newlines[i]);
+        }
+    }
+    std::vector<Token> tokens(first_token[count]);
+    pool.parallel_for(count, [&](std::size_t i) {
+        auto out = tokens.begin() + static_cast<std::ptrdiff_t>(first_token[i]);
+        for (auto tk : parts[i]) {
+            tk.line += first_line[i];
+            *out++ = tk;
+        }
+        parts[i] = {};
+    });
+    return tokens;
+}
+
+}  // namespace lexer
@@ -0,0 +1,203 @@
+#include "../../include/lexer/scan.hpp"
+
+#include <bit>
+#include <cstdint>
+
+#if defined(__x86_64__)
+#define QAC_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+namespace lexer {
+
+namespace {
+
+[[nodiscard]] constexpr auto is_blank(char c) -> bool { return c == ' ' || c == '\t' || c == '\r'; }
+
+[[nodiscard]] constexpr auto is_digit(char c) -> bool { return c >= '0' && c <= '9'; }
+
+[[nodiscard]] constexpr auto is_identifier(char c) -> bool {
+    const char lower = static_cast<char>(c | 0x20);
+    return (lower >= 'a' && lower <= 'z') || is_digit(c) || c == '_';
+}
+
+template <auto Continues>
+[[nodiscard]] auto scalar_run(const char* p, const char* end) -> const char* {
+    while (p != end && Continues(*p)) {
+        p++;
+    }
+    return p;
+}
+
+[[nodiscard]] auto scalar_find_newline(const char* p, const char* end) -> const char* {
+    while (p != end && *p != '\n') {
+        p++;
+    }
+    return p;
+}
+
+constexpr Scanner scalar_scanner = {
+    .name = "scalar",
+    .skip_blanks = scalar_run<is_blank>,
+    .find_newline = scalar_find_newline,
+    .identifier_end = scalar_run<is_identifier>,
+    .digits_end = scalar_run<is_digit>,
+};
+
+#ifdef QAC_SCAN_X86
+
+// Each matcher sets a byte of its mask where the byte continues the run. Bytes of 0x80 and above
+// are negative to the signed compares, so they never fall inside an ASCII range.
+
+[[nodiscard]] auto sse2_in_range(__m128i v, char lo, char hi) -> __m128i {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                         _mm_cmplt_epi8(v, _mm_set1_epi8(static_cast<char>(hi + 1))));
+}
+
+struct Sse2Blank {
+    [[nodiscard]] static auto match(__m128i v) -> __m128i {
+        return _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                                         _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+                            _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')));
+    }
+};
+
+struct Sse2NotNewline {
+    [[nodiscard]] static auto match(__m128i v) -> __m128i {
+        return _mm_xor_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_set1_epi8(-1));
+    }
+};
+
+struct Sse2Identifier {
+    [[nodiscard]] static auto match(__m128i v) -> __m128i {
+        const auto alpha = sse2_in_range(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 'z');
+        const auto digit = sse2_in_range(v, '0', '9');
+        return _mm_or_si128(_mm_or_si128(alpha, digit), _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+    }
+};
+
+struct Sse2Digit {
+    [[nodiscard]] static auto match(__m128i v) -> __m128i { return sse2_in_range(v, '0', '9'); }
+};
+
+// SSE2 is part of x86-64, so this needs no target attribute and no CPUID check there
+template <typename Matcher, auto Continues>
+[[nodiscard]] auto sse2_run(const char* p, const char* end) -> const char* {
+    while (end - p >= 16) {
+        const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const auto matched = static_cast<std::uint32_t>(_mm_movemask_epi8(Matcher::match(v)));
+        const auto stop = ~matched & 0xffffu;
+        if (stop != 0) {
+            return p + std::countr_zero(stop);
+        }
+        p += 16;
+    }
+    return scalar_run<Continues>(p, end);
+}
+
+[[nodiscard]] constexpr auto not_newline(char c) -> bool { return c != '\n'; }
+
+constexpr Scanner sse2_scanner = {
+    .name = "sse2",
+    .skip_blanks = sse2_run<Sse2Blank, is_blank>,
+    .find_newline = sse2_run<Sse2NotNewline, not_newline>,
+    .identifier_end = sse2_run<Sse2Identifier, is_identifier>,
+    .digits_end = sse2_run<Sse2Digit, is_digit>,
+};
+
+#define QAC_AVX2 __attribute__((target("avx2")))
+
+[[nodiscard]] QAC_AVX2 inline auto avx2_in_range(__m256i v, char lo, char hi) -> __m256i {
+    return _mm256_and_si256(
+        _mm256_cmpgt_epi8(v, _mm256_set1_epi8(static_cast<char>(lo - 1))),
+        _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), v));
+}
+
+struct Avx2Blank {
+    [[nodiscard]] QAC_AVX2 static auto match(__m256i v) -> __m256i {
+        return _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                                               _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+                               _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')));
+    }
+};
+
+struct Avx2NotNewline {
+    [[nodiscard]] QAC_AVX2 static auto match(__m256i v) -> __m256i {
+        return _mm256_xor_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')),
+                                _mm256_set1_epi8(-1));
+    }
+};
+
+struct Avx2Identifier {
+    [[nodiscard]] QAC_AVX2 static auto match(__m256i v) -> __m256i {
+        const auto alpha = avx2_in_range(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), 'a', 'z');
+        const auto digit = avx2_in_range(v, '0', '9');
+        return _mm256_or_si256(_mm256_or_si256(alpha, digit),
+                               _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+    }
+};
+
+struct Avx2Digit {
+    [[nodiscard]] QAC_AVX2 static auto match(__m256i v) -> __m256i {
+        return avx2_in_range(v, '0', '9');
+    }
+};
+
+// 32 bytes at a time, then the SSE2 loop for what is left
+template <typename Matcher, typename Sse2Matcher, auto Continues>
+[[nodiscard]] QAC_AVX2 auto avx2_run(const char* p, const char* end) -> const char* {
+    while (end - p >= 32) {
+        const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const auto stop = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(Matcher::match(v)));
+        if (stop != 0) {
+            return p + std::countr_zero(stop);
+        }
+        p += 32;
+    }
+    return sse2_run<Sse2Matcher, Continues>(p, end);
+}
+
+constexpr Scanner avx2_scanner = {
+    .name = "avx2",
+    .skip_blanks = avx2_run<Avx2Blank, Sse2Blank, is_blank>,
+    .find_newline = avx2_run<Avx2NotNewline, Sse2NotNewline, not_newline>,
+    .identifier_end = avx2_run<Avx2Identifier, Sse2Identifier, is_identifier>,
+    .digits_end = avx2_run<Avx2Digit, Sse2Digit, is_digit>,
+};
+
+#undef QAC_AVX2
+
+#endif  // QAC_SCAN_X86
+
+[[nodiscard]] auto select_scanner() -> const Scanner& {
+#ifdef QAC_SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return avx2_scanner;
+    }
+    return sse2_scanner;
+#else
+    return scalar_scanner;
+#endif
+}
+
+}  // namespace
+
+auto active_scanner() -> const Scanner& {
+    static const Scanner& scanner = select_scanner();
+    return scanner;
+}
+
+auto available_scanners() -> std::vector<Scanner> {
+    std::vector<Scanner> scanners = {scalar_scanner};
+#ifdef QAC_SCAN_X86
+    scanners.push_back(sse2_scanner);
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        scanners.push_back(avx2_scanner);
+    }
+#endif
+    return scanners;
+}
+
+}  // namespace lexer
@@ -1,61 +1,24 @@
 #include "../../include/parser/syntax_utils.hpp"
 
-#include <set>
-
-auto isTypeSpecifier(const Token token) -> bool {
+auto isTypeSpecifier(const Token& token) -> bool {
     return token.type == TokType::TOKEN_T_INT || token.type == TokType::TOKEN_T_VOID ||
            token.type == TokType::TOKEN_T_FLOAT;
 }
 
-auto isStmtBegin(const Token t) -> bool {
-    std::set<TokType> stmtBeginSet = {
-        TokType::TOKEN_RETURN, TokType::TOKEN_IDENTIFIER, TokType::TOKEN_STAR,
-        TokType::TOKEN_IF,     TokType::TOKEN_FOR,
-    };
-    return stmtBeginSet.find(t.type) != stmtBeginSet.end();
+auto isStmtBegin(const Token& t) -> bool {
+    switch (t.type) {
+        case TokType::TOKEN_RETURN:
+        case TokType::TOKEN_IDENTIFIER:
+        case TokType::TOKEN_STAR:
+        case TokType::TOKEN_IF:
+        case TokType::TOKEN_FOR:
+            return true;
+        default:
+            return false;
+    }
 }
 
-auto isFuncBegin(const Token first, const Token second, const Token third) -> bool {
+auto isFuncBegin(const Token& first, const Token& second, const Token& third) -> bool {
     return isTypeSpecifier(first) && second.type == TokType::TOKEN_IDENTIFIER &&
            third.type == TokType::TOKEN_LEFT_PAREN;
 }
-
-auto __EqualsSignLookahead(const unsigned long current, const std::vector<Token>& g_tokens)
-    -> bool {
-    unsigned long i = current;
-    unsigned margin = 0;
-    while (i < g_tokens.size()) {
-        if (g_tokens[i].type == TokType::TOKEN_EQUAL) {
-            return true;
-        }
-        if (g_tokens[i].type == TokType::TOKEN_SEMICOLON) {
-            return false;
-        }
-        if (g_tokens[i].type == TokType::TOKEN_LEFT_BRACE) {
-            return false;
-        }
-        if (g_tokens[i].type == TokType::TOKEN_RIGHT_BRACE) {
-            return false;
-        }
-        if (g_tokens[i].type == TokType::TOKEN_LEFT_PAREN) {
-            margin++;
-        }
-        if (g_tokens[i].type == TokType::TOKEN_RIGHT_PAREN) {
-            if (margin == 0) {
-                return false;
-            }
-            margin--;
-        }
-        if (g_tokens[i].type == TokType::TOKEN_LEFT_BRACKET) {
-            margin++;
-        }
-        if (g_tokens[i].type == TokType::TOKEN_RIGHT_BRACKET) {
-            if (margin == 0) {
-                return false;
-            }
-            margin--;
-        }
-        i++;
-    }
-    return false;
-}
\ No newline at end of file
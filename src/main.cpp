@@ -2,35 +2,205 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "../include/driver.hpp"
+#include "../include/server.hpp"
+#include "../include/support/thread_pool.hpp"
+#include "../include/support/trace.hpp"
+
+namespace {
+
+// far more threads than any machine this runs on has cores
+constexpr unsigned max_jobs = 1024;
+
+enum LongOption {
+    OPT_DUMP = 256,
+    OPT_TIME_REPORT,
+    OPT_TIME_REPORT_JSON,
+    OPT_TRACE,
+    OPT_SERVER,
+    OPT_CONNECT,
+    OPT_CACHE_DIR,
+    OPT_CACHE_SIZE,
+    OPT_FUSED_FRONT_END,
+    OPT_PARALLEL_FRONT_END
+};
+
+const option long_options[] = {
+    {"dump", required_argument, nullptr, OPT_DUMP},
+    {"time-report", no_argument, nullptr, OPT_TIME_REPORT},
+    {"time-report-json", required_argument, nullptr, OPT_TIME_REPORT_JSON},
+    {"trace", required_argument, nullptr, OPT_TRACE},
+    {"server", required_argument, nullptr, OPT_SERVER},
+    {"connect", required_argument, nullptr, OPT_CONNECT},
+    {"cache-dir", required_argument, nullptr, OPT_CACHE_DIR},
+    {"cache-size", required_argument, nullptr, OPT_CACHE_SIZE},
+    {"fused-front-end", no_argument, nullptr, OPT_FUSED_FRONT_END},
+    {"parallel-front-end", no_argument, nullptr, OPT_PARALLEL_FRONT_END},
+    {nullptr, 0, nullptr, 0},
+};
+
+void usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [--dump=st,ast,ir,opt-ir,target-ir] [--time-report] "
+            "[--time-report-json=<file>] [--trace=<file>] [-j <jobs>] "
+            "[--cache-dir=<dir>] [--cache-size=<MiB>] [--fused-front-end] "
+            "[--parallel-front-end] -o <outfile> <input file>...\n"
+            "       %s --server <socket> [-j <threads>]\n"
+            "       %s --connect=<socket> [--time-report] [--fused-front-end] "
+            "[--parallel-front-end] -o <outfile> <input file>\n"
+            "With several inputs, or an <outfile> ending in '/', -o names the output directory.\n",
+            program, program, program);
+}
+
+// A decimal count that is the whole of `text`, nullopt for anything else, a sign included.
+[[nodiscard]] auto parse_count(const char* text) -> std::optional<unsigned long long> {
+    unsigned long long value = 0;
+    const auto* end = text + strlen(text);
+    const auto [last, ec] = std::from_chars(text, end, value);
+    if (ec != std::errc() || last != end) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+}  // namespace
 
 int main(int argc, char* argv[]) {
     if (argc <= 1) {
-        fprintf(stderr, "Usage: %s -o <outfile> <input file>\n", argv[0]);
+        usage(argv[0]);
         return EXIT_FAILURE;
     }
 
     int opt;
-    std::string outfile = "test.asm";
+    std::string outfile = "";
+    std::string trace_file = "";
+    std::string server_socket = "";
+    std::string connect_socket = "";
+    DriverOptions options;
 
-    while ((opt = getopt(argc, argv, "o:")) != -1) {
+    while ((opt = getopt_long(argc, argv, "o:j:", long_options, nullptr)) != -1) {
         switch (opt) {
             case 'o':
                 outfile = optarg;
                 break;
+            case 'j': {
+                // 0 is one thread per core
+                const auto jobs = parse_count(optarg);
+                if (!jobs.has_value() || jobs.value() > max_jobs) {
+                    fprintf(stderr, "Invalid job count -j %s, expected 0 to %u\n", optarg,
+                            max_jobs);
+                    return EXIT_FAILURE;
+                }
+                options.jobs = jobs.value() == 0 ? support::default_thread_count()
+                                                 : static_cast<unsigned>(jobs.value());
+                break;
+            }
+            case OPT_DUMP: {
+                const auto stages = parse_dump_stages(optarg);
+                if (!stages.has_value()) {
+                    fprintf(stderr, "Unknown stage in --dump=%s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                options.dumps = stages.value();
+                break;
+            }
+            case OPT_TIME_REPORT:
+                options.time_report = true;
+                break;
+            case OPT_TIME_REPORT_JSON:
+                options.time_report_json = optarg;
+                break;
+            case OPT_TRACE:
+                trace_file = optarg;
+                support::trace::enable();
+                break;
+            case OPT_SERVER:
+                server_socket = optarg;
+                break;
+            case OPT_CONNECT:
+                connect_socket = optarg;
+                break;
+            case OPT_CACHE_DIR:
+                options.cache_dir = optarg;
+                break;
+            case OPT_CACHE_SIZE: {
+                constexpr auto max_mib = std::numeric_limits<std::uintmax_t>::max() >> 20;
+                const auto mib = parse_count(optarg);
+                if (!mib.has_value() || mib.value() == 0 || mib.value() > max_mib) {
+                    fprintf(stderr, "Invalid cache size --cache-size=%s, expected 1 to %ju MiB\n",
+                            optarg, max_mib);
+                    return EXIT_FAILURE;
+                }
+                options.cache_max_bytes = std::uintmax_t{mib.value()} << 20;
+                break;
+            }
+            case OPT_FUSED_FRONT_END:
+                options.fused_front_end = true;
+                break;
+            case OPT_PARALLEL_FRONT_END:
+                options.parallel_front_end = true;
+                break;
             default:
-                fprintf(stderr, "Usage: %s -o <outfile> <input file>\n", argv[0]);
+                usage(argv[0]);
                 return EXIT_FAILURE;
         }
     }
 
+    if (!server_socket.empty()) {
+        // everything but the thread count comes with each request
+        if (optind < argc || !outfile.empty() || !options.dumps.empty() ||
+            options.time_report || options.time_report_json.has_value() || !trace_file.empty() ||
+            options.cache_dir.has_value() ||
+            options.cache_max_bytes != DriverOptions{}.cache_max_bytes ||
+            options.fused_front_end || options.parallel_front_end || !connect_socket.empty()) {
+            fprintf(stderr, "--server takes no input, -o or options other than -j\n");
+            return EXIT_FAILURE;
+        }
+        return server::serve(server_socket, options.jobs);
+    }
+
     if (optind >= argc) {
         fprintf(stderr, "Expected input file after options\n");
         return EXIT_FAILURE;
     }
 
-    char* sourcefile = argv[optind];
-    return runfile(sourcefile, outfile);
+    const std::vector<std::string> sourcefiles(argv + optind, argv + argc);
+    if (!connect_socket.empty()) {
+        // the server compiles in memory on its own threads, -j is left to `--server -j`
+        if (sourcefiles.size() > 1 || !options.dumps.empty() ||
+            options.time_report_json.has_value() || !trace_file.empty() ||
+            options.cache_dir.has_value() ||
+            options.cache_max_bytes != DriverOptions{}.cache_max_bytes) {
+            fprintf(stderr,
+                    "--connect takes a single input and no --dump, --time-report-json, --trace, "
+                    "--cache-dir or --cache-size\n");
+            return EXIT_FAILURE;
+        }
+        return server::compile_remote(connect_socket, sourcefiles.front().c_str(),
+                                      outfile.empty() ? "test.asm" : outfile, options);
+    }
+
+    const bool to_directory = sourcefiles.size() > 1 || outfile.ends_with('/');
+    const auto result =
+        to_directory ? runfiles(sourcefiles, outfile.empty() ? "." : outfile, options)
+                     : runfile(sourcefiles.front().c_str(), outfile.empty() ? "test.asm" : outfile,
+                               options);
+    if (!trace_file.empty()) {
+        try {
+            support::trace::write(trace_file);
+        } catch (const std::runtime_error& e) {
+            fprintf(stderr, "%s\n", e.what());
+            return EXIT_FAILURE;
+        }
+    }
+    return result;
 }
@@ -2,45 +2,73 @@
 
 #include <source_location>
 
+#include "../../include/compiler/ast_builder.hpp"
+#include "../../include/parser/operators.hpp"
 #include "../../include/parser/syntax_utils.hpp"
 
 #define DEBUG 0
 
-static unsigned long current = 0;
-std::vector<Token> g_tokens;
+template <typename Builder>
+BasicParser<Builder>::BasicParser(std::span<const Token> p_tokens, std::string_view p_source)
+    : stream(p_tokens), source(p_source), builder(), pending_lists() {}
 
-auto parser_log(const char* msg, const std::source_location loc = std::source_location::current())
-    -> void {
+template <typename Builder>
+BasicParser<Builder>::BasicParser(std::string_view p_source)
+    : stream(p_source), source(p_source), builder(), pending_lists() {}
+
+// the text of a token; the syntax tree keeps these views rather than copies
+template <typename Builder>
+auto BasicParser<Builder>::lexeme(const Token& tk) const -> std::string_view {
+    return tk.lexeme(source);
+}
+
+template <typename Builder>
+template <typename T, typename F>
+auto BasicParser<Builder>::finish_list(std::size_t begin, F&& build) {
+    auto& items = pending<T>();
+    auto list = build(std::span<T>(items).subspan(begin));
+    items.erase(items.begin() + static_cast<std::ptrdiff_t>(begin), items.end());
+    return list;
+}
+
+template <typename Builder>
+template <typename T>
+auto BasicParser<Builder>::finish_list(std::size_t begin) -> st::NodeList<T> {
+    return finish_list<T>(begin, [this](std::span<const T> items) {
+        return builder.syntax_tree().add_list(items);
+    });
+}
+
+template <typename Builder>
+auto BasicParser<Builder>::parser_log(const char* msg, const std::source_location loc) -> void {
     if (DEBUG) {
         std::cout << "parser: " << msg << " at " << loc.file_name() << ":" << loc.line() << ":"
-                  << loc.column() << " current_token: " << g_tokens[current].lexeme << std::endl;
+                  << loc.column() << " current_token: " << lexeme(peek()) << std::endl;
     }
 }
 
-auto peek() -> Token {
-    if (current >= g_tokens.size()) {
-        return Token{TokType::TOKEN_FEOF, ""};
-    }
-    return g_tokens[current];
+template <typename Builder>
+auto BasicParser<Builder>::peek() -> const Token& {
+    return stream.peek();
 }
 
-Token peekn(size_t n) {
-    if (current + n >= g_tokens.size()) {
-        return Token{TokType::TOKEN_FEOF, ""};
-    }
-    return g_tokens[current + n];
+template <typename Builder>
+auto BasicParser<Builder>::peekn(size_t n) -> const Token& {
+    return stream.peek(n);
 }
 
-Token advance() {
-    if (current >= g_tokens.size()) {
-        return Token{TokType::TOKEN_FEOF, ""};
-    }
-    return g_tokens[current++];
+template <typename Builder>
+auto BasicParser<Builder>::advance() -> Token {
+    return stream.advance();
 }
 
-Token previous() { return g_tokens[current - 1]; }
+template <typename Builder>
+auto BasicParser<Builder>::previous() const -> const Token& {
+    return stream.previous();
+}
 
-bool match(TokType type) {
+template <typename Builder>
+auto BasicParser<Builder>::match(TokType type) -> bool {
     if (peek().type == type) {
         advance();
         return true;
@@ -48,17 +76,23 @@ bool match(TokType type) {
     return false;
 }
 
-bool isAtEnd() { return peek().type == TokType::TOKEN_FEOF; }
+template <typename Builder>
+auto BasicParser<Builder>::isAtEnd() -> bool {
+    return peek().type == TokType::TOKEN_FEOF;
+}
 
-void consume(TokType typ) {
+template <typename Builder>
+auto BasicParser<Builder>::consume(TokType typ) -> void {
     if (match(typ) == false) {
         throw std::runtime_error("Expected token of type " + std::to_string(static_cast<int>(typ)) +
                                  " found " + std::to_string(static_cast<int>(peek().type)));
     }
 }
 
-auto parseDeclarationSpecs() -> std::vector<st::DeclarationSpecifier> {
-    std::vector<st::DeclarationSpecifier> declspecs;
+template <typename Builder>
+auto BasicParser<Builder>::parseDeclarationSpecs() -> st::NodeList<st::DeclarationSpecifier> {
+    auto& declspecs = pending<st::DeclarationSpecifier>();
+    const auto begin = declspecs.size();
     while (isTypeSpecifier(peek())) {
         if (peek().type == TokType::TOKEN_T_INT) {
             declspecs.push_back(st::DeclarationSpecifier{
@@ -69,17 +103,18 @@ auto parseDeclarationSpecs() -> std::vector<st::DeclarationSpecifier> {
         } else {
             const auto ts = st::TypeSpecifier{
                 .type = st::TypeSpecifier::Type::IDEN,
-                .iden = peek().lexeme,
+                .iden = lexeme(peek()),
             };
             const auto ds = st::DeclarationSpecifier{.typespecifier = ts};
             declspecs.push_back(ds);
         }
         advance();
     }
-    return declspecs;
+    return finish_list<st::DeclarationSpecifier>(begin);
 }
 
-std::optional<st::Pointer> parsePointer() {
+template <typename Builder>
+auto BasicParser<Builder>::parsePointer() -> std::optional<st::Pointer> {
     size_t count = 0;
     while (match(TokType::TOKEN_STAR)) {
         count++;
@@ -90,22 +125,22 @@ std::optional<st::Pointer> parsePointer() {
     return st::Pointer{.level = count};
 }
 
-std::string parseIdentifier() {
-    const auto tk = peek();
-    if (tk.type == TokType::TOKEN_IDENTIFIER) {
-        advance();
-        return tk.lexeme;
+template <typename Builder>
+auto BasicParser<Builder>::parseIdentifier() -> std::string_view {
+    if (peek().type == TokType::TOKEN_IDENTIFIER) {
+        return lexeme(advance());
     }
-    std::string msg = "expected identifier, found " + tk.lexeme;
+    std::string msg = "expected identifier, found " + std::string(lexeme(peek()));
     throw std::runtime_error(msg);
 }
 
-st::ParamTypeList parseParamTypeList() {
-    std::vector<st::ParameterDeclaration> params;
+template <typename Builder>
+auto BasicParser<Builder>::parseParamTypeList() -> st::ParamTypeList {
+    const auto begin = pending<st::ParameterDeclaration>().size();
     while (!match(TokType::TOKEN_RIGHT_PAREN)) {
         const auto declspecs = parseDeclarationSpecs();
         const auto decl = parseDeclarator();
-        params.push_back(
+        pending<st::ParameterDeclaration>().push_back(
             st::ParameterDeclaration{.declarationSpecifiers = declspecs, .declarator = decl});
         if (match(TokType::TOKEN_COMMA) == false) {
             break;
@@ -113,11 +148,13 @@ st::ParamTypeList parseParamTypeList() {
     }
     if (match(TokType::TOKEN_RIGHT_PAREN)) {
     }
-    return st::ParamTypeList{.params = params, .va_args = false};
+    return st::ParamTypeList{.params = finish_list<st::ParameterDeclaration>(begin),
+                             .va_args = false};
 }
 
 // This should be more recursive than it is in parsing DirectDeclarators. But as long as it works..
-st::DirectDeclarator parseDirectDeclartor() {
+template <typename Builder>
+auto BasicParser<Builder>::parseDirectDeclartor() -> st::DirectDeclarator {
     auto iden = parseIdentifier();
     if (match(TokType::TOKEN_LEFT_PAREN)) {
         auto paramList = parseParamTypeList();
@@ -129,7 +166,7 @@ st::DirectDeclarator parseDirectDeclartor() {
     // not looking for type qualifiers
     if (match(TokType::TOKEN_LEFT_BRACKET)) {
         parser_log("found left bracket");
-        auto expr = parseAssignmentExpression();
+        auto expr = builder.array_size(parseExpression());
         consume(TokType::TOKEN_RIGHT_BRACKET);
         auto ad = st::ArrayDirectDeclarator{.name = iden, .size = expr};
         return st::DirectDeclarator{.kind = st::DeclaratorKind::ARRAY, .declarator = ad};
@@ -139,27 +176,25 @@ st::DirectDeclarator parseDirectDeclartor() {
     return st::DirectDeclarator{.kind = st::DeclaratorKind::VARIABLE, .declarator = vd};
 }
 
-auto parseDeclarator() -> st::Declarator {
+template <typename Builder>
+auto BasicParser<Builder>::parseDeclarator() -> st::Declarator {
     const auto ptr = parsePointer();
     const auto dd = parseDirectDeclartor();
     return st::Declarator{.pointer = ptr, .directDeclarator = dd};
 }
 
-auto parsePrimaryExpression() -> st::Expression {
+template <typename Builder>
+auto BasicParser<Builder>::parsePrimaryExpression() -> Expression {
     parser_log("parsing primary expression");
     if (peek().type == TokType::TOKEN_IDENTIFIER) {
-        const auto lexeme = peek().lexeme;
-        advance();
-        return std::make_shared<st::PrimaryExpression>(lexeme);
+        return builder.primary(st::PrimaryExpression(lexeme(advance())));
     }
+    // the lexer already converted number literals
     if (peek().type == TokType::TOKEN_NUMBER) {
-        const auto lexeme = peek().lexeme;
-        advance();
-        if (lexeme.find('.') != std::string::npos) {
-            return std::make_shared<st::PrimaryExpression>(std::stof(lexeme));
-        }
-
-        return std::make_shared<st::PrimaryExpression>(std::stoi(lexeme));
+        return builder.primary(st::PrimaryExpression(advance().int_value));
+    }
+    if (peek().type == TokType::TOKEN_FLOAT_NUMBER) {
+        return builder.primary(st::PrimaryExpression(advance().float_value));
     }
     if (peek().type == TokType::TOKEN_LEFT_PAREN) {
         consume(TokType::TOKEN_LEFT_PAREN);
@@ -167,199 +202,155 @@ auto parsePrimaryExpression() -> st::Expression {
         consume(TokType::TOKEN_RIGHT_PAREN);
         return expr;
     }
-    throw std::runtime_error("Expected primary expression found " + peek().lexeme);
+    throw std::runtime_error("Expected primary expression found " +
+                             std::string(lexeme(peek())));
 }
 
-auto parsePostfixExpression() -> st::Expression {
+template <typename Builder>
+auto BasicParser<Builder>::parsePostfixExpression() -> Expression {
     parser_log("parsing postfix expression");
-    auto primary = parsePrimaryExpression();
+    // a name directly followed by its arguments or index is never an operand of its own
+    std::string_view name;
+    const auto& next = peekn(1);
+    if (peek().type == TokType::TOKEN_IDENTIFIER &&
+        (next.type == TokType::TOKEN_LEFT_PAREN || next.type == TokType::TOKEN_LEFT_BRACKET)) {
+        name = lexeme(advance());
+    } else {
+        auto primary = parsePrimaryExpression();
+        if (peek().type != TokType::TOKEN_LEFT_PAREN &&
+            peek().type != TokType::TOKEN_LEFT_BRACKET) {
+            return primary;
+        }
+        name = builder.callee_name(primary);
+    }
+
     // function call
     if (match(TokType::TOKEN_LEFT_PAREN)) {
-        std::vector<st::Expression> args;
+        const auto begin = pending<Expression>().size();
         while (!match(TokType::TOKEN_RIGHT_PAREN)) {
             auto expr = parseExpression();
-            args.push_back(std::move(expr));
+            pending<Expression>().push_back(std::move(expr));
             if (match(TokType::TOKEN_COMMA) == false) {
                 break;
             }
         }
         if (match(TokType::TOKEN_RIGHT_PAREN)) {
         }
-        const auto primary_expr = std::get<std::shared_ptr<st::PrimaryExpression>>(primary).get();
-        const auto name = primary_expr->idenValue;
-        return std::make_shared<st::FunctionCallExpression>(name, std::move(args));
+        return finish_list<Expression>(
+            begin, [this, name](std::span<Expression> args) { return builder.call(name, args); });
     }
 
     // left hand side of a[3] = 5;
-    if (match(TokType::TOKEN_LEFT_BRACKET)) {
-        parser_log("parsePostfixExpression(): found left bracket");
-        auto expr = parseExpression();
-        const std::string name =
-            std::get<std::shared_ptr<st::PrimaryExpression>>(primary)->idenValue;
-        parser_log("parsePostfixExpression(): parsed expr");
-        consume(TokType::TOKEN_RIGHT_BRACKET);
-        return std::make_shared<st::ArrayAccessExpression>(name, std::move(expr));
-    }
-
-    return primary;
+    consume(TokType::TOKEN_LEFT_BRACKET);
+    parser_log("parsePostfixExpression(): found left bracket");
+    auto expr = parseExpression();
+    parser_log("parsePostfixExpression(): parsed expr");
+    consume(TokType::TOKEN_RIGHT_BRACKET);
+    return builder.array_access(name, std::move(expr));
 }
 
-st::Expression parseUnaryExpression() {
+template <typename Builder>
+auto BasicParser<Builder>::parseUnaryExpression() -> Expression {
     if (match(TokType::TOKEN_STAR)) {
-        auto expr = parseUnaryExpression();
-        return std::make_shared<st::UnaryExpression>(st::UnaryExpressionType::DEREF,
-                                                     std::move(expr));
+        return builder.unary(st::UnaryExpressionType::DEREF, parseUnaryExpression());
     }
     if (match(TokType::TOKEN_AMPERSAND)) {
-        auto expr = parseUnaryExpression();
-        return std::make_shared<st::UnaryExpression>(st::UnaryExpressionType::ADDR,
-                                                     std::move(expr));
+        return builder.unary(st::UnaryExpressionType::ADDR, parseUnaryExpression());
     }
     if (match(TokType::TOKEN_MINUS)) {
-        auto expr = parseUnaryExpression();
-        return std::make_shared<st::UnaryExpression>(st::UnaryExpressionType::NEG, std::move(expr));
+        return builder.unary(st::UnaryExpressionType::NEG, parseUnaryExpression());
     }
     return parsePostfixExpression();
 }
 
-st::Expression parseMultiplicativeExpression() {
+// Precedence climbing: folds operators binding at least `min_power` into the expression, so a
+// primary expression costs one call here plus its unary and postfix parsing, whatever the
+// number of precedence levels. The left hand side of an assignment is parsed like any other
+// operand and becomes a target only when an `=` follows it.
+template <typename Builder>
+auto BasicParser<Builder>::parseBinaryExpression(std::uint8_t min_power) -> Expression {
     auto lhs = parseUnaryExpression();
-    while (match(TokType::TOKEN_STAR) || match(TokType::TOKEN_SLASH)) {
-        auto op_token = previous();
-        auto op = st::MultiplicativeExpressionType::Mult;
-        if (op_token.type == TokType::TOKEN_SLASH) {
-            op = st::MultiplicativeExpressionType::Div;
+    std::uint8_t non_associative_power = 0;
+    while (true) {
+        const auto& op = binary_operator(peek().type);
+        if (op.binding_power == 0 || op.binding_power < min_power ||
+            op.binding_power == non_associative_power) {
+            return lhs;
         }
-        auto rhs = parseUnaryExpression();
-        lhs = std::make_shared<st::MultiplicativeExpression>(std::move(lhs), std::move(rhs), op);
-    }
-    return lhs;
-}
-
-st::Expression parseAdditiveExpression() {
-    auto lhs = parseMultiplicativeExpression();
-    while (match(TokType::TOKEN_PLUS) || match(TokType::TOKEN_MINUS)) {
-        auto op_token = previous();
-        auto op = st::AdditiveExpressionType::ADD;
-        if (op_token.type == TokType::TOKEN_MINUS) {
-            op = st::AdditiveExpressionType::SUB;
-        }
-        auto rhs = parseMultiplicativeExpression();
-        lhs = std::make_shared<st::AdditiveExpression>(std::move(lhs), std::move(rhs), op);
-    }
-    return lhs;
-}
-
-st::Expression parseRelationalExpression() {
-    parser_log("parsing relational expression");
-    auto lhs = parseAdditiveExpression();
-    if (match(TOKEN_GREATER)) {
-        auto op_token = previous();
-        auto op = st::AdditiveExpressionType::GT;
-        auto rhs = parseAdditiveExpression();
-        return std::make_shared<st::AdditiveExpression>(std::move(lhs), std::move(rhs), op);
-    }
-    if (match(TOKEN_LESS)) {
-        auto op_token = previous();
-        auto op = st::AdditiveExpressionType::LT;
-        auto rhs = parseAdditiveExpression();
-        return std::make_shared<st::AdditiveExpression>(std::move(lhs), std::move(rhs), op);
-    }
-    return lhs;
-}
-
-st::Expression parseEqualityExpression() {
-    parser_log("parsing equality expression");
-    auto lhs = parseRelationalExpression();
-    if (match(TokType::TOKEN_EQUAL_EQUAL) || match(TokType::TOKEN_BANG_EQUAL)) {
-        auto op_token = previous();
-        auto op = st::AdditiveExpressionType::EQ;
-        if (op_token.type == TokType::TOKEN_BANG_EQUAL) {
-            op = st::AdditiveExpressionType::NEQ;
+        advance();
+        builder.begin_right_operand(op.op, lhs);
+        // operands of a left associative operator must bind tighter than it
+        const auto right_power = static_cast<std::uint8_t>(
+            op.associativity == Associativity::RIGHT ? op.binding_power : op.binding_power + 1);
+        auto rhs = parseBinaryExpression(right_power);
+        lhs = builder.binary(op.op, std::move(lhs), std::move(rhs));
+        if (op.associativity == Associativity::NON_ASSOCIATIVE) {
+            non_associative_power = op.binding_power;
         }
-        auto rhs = parseRelationalExpression();
-        return std::make_shared<st::AdditiveExpression>(std::move(lhs), std::move(rhs), op);
     }
-    return lhs;
 }
 
-st::Expression parseAssignmentExpression() {
-    if (__EqualsSignLookahead(current, g_tokens) == false) {
-        parser_log("parsing equality expression");
-        return parseEqualityExpression();
-    }
-    auto lhs = parseEqualityExpression();
-    parser_log("parseAssignmentExpression(): parsed lhs");
-    consume(TokType::TOKEN_EQUAL);
-    auto rhs = parseEqualityExpression();
-    return std::make_shared<st::AssignmentExpression>(std::move(lhs), std::move(rhs));
+template <typename Builder>
+auto BasicParser<Builder>::parseExpression() -> Expression {
+    return parseBinaryExpression(1);
 }
 
-auto parseExpression() -> st::Expression { return parseAssignmentExpression(); }
-
-auto parseReturnStatement() -> std::shared_ptr<st::ReturnStatement> {
+template <typename Builder>
+auto BasicParser<Builder>::parseReturnStatement() -> Statement {
+    builder.begin_return();
     auto expr = parseExpression();
     consume(TokType::TOKEN_SEMICOLON);
-    return std::make_shared<st::ReturnStatement>(std::move(expr));
+    return builder.return_statement(std::move(expr));
 }
 
-auto parseExpressionStatement() -> std::shared_ptr<st::ExpressionStatement> {
+template <typename Builder>
+auto BasicParser<Builder>::parseExpressionStatement() -> Statement {
     parser_log("parsing expression statement");
     auto expr = parseExpression();
     parser_log("parseExpressionStatement(): parsed expression");
     consume(TokType::TOKEN_SEMICOLON);
-    return std::make_shared<st::ExpressionStatement>(std::move(expr));
+    return builder.expression_statement(std::move(expr));
 }
 
-std::shared_ptr<st::SelectionStatement> parseIfStatement() {
+template <typename Builder>
+auto BasicParser<Builder>::parseIfStatement() -> Statement {
     consume(TokType::TOKEN_LEFT_PAREN);
     auto expr = parseExpression();
     consume(TokType::TOKEN_RIGHT_PAREN);
     auto thenStmt = parseCompoundStatement();
-    auto thenStmtUnique = std::make_shared<st::CompoundStatement>(std::move(thenStmt));
     if (match(TokType::TOKEN_ELSE)) {
         auto elseStmt = parseCompoundStatement();
-        auto elseStmtUnique = std::make_shared<st::CompoundStatement>(std::move(elseStmt));
-        return std::make_shared<st::SelectionStatement>(std::move(expr), std::move(thenStmtUnique),
-                                                        std::move(elseStmtUnique));
+        return builder.if_statement(std::move(expr), std::move(thenStmt), std::move(elseStmt));
     }
-    return std::make_shared<st::SelectionStatement>(std::move(expr), std::move(thenStmtUnique),
-                                                    nullptr);
-}
-
-auto parseForDeclaration() -> st::ForDeclaration {
-    auto declspecs = parseDeclarationSpecs();
-    auto decl = parseInitDeclarator();
-    return st::ForDeclaration(declspecs, std::move(decl));
+    return builder.if_statement(std::move(expr), std::move(thenStmt), std::nullopt);
 }
 
-auto parseForStatement() -> std::shared_ptr<st::ForStatement> {
+template <typename Builder>
+auto BasicParser<Builder>::parseForStatement() -> Statement {
     consume(TokType::TOKEN_LEFT_PAREN);
     // if the next thing is a declaration specifier then we want to parse a
     // forDeclaration. else we want to parse an expression
-    st::ForDeclaration decl({}, {});
-    std::optional<st::Expression> cond = std::nullopt;
-    std::optional<st::Expression> inc = std::nullopt;
-    if (isTypeSpecifier(peek())) {
-        // should parse the semicolon
-        decl = parseForDeclaration();
-        if (peek().type != TokType::TOKEN_SEMICOLON) {
-            cond = parseExpression();
-            consume(TokType::TOKEN_SEMICOLON);
-        } else {
-            consume(TokType::TOKEN_SEMICOLON);
-        }
-        if (peek().type != TokType::TOKEN_RIGHT_PAREN) {
-            inc = parseExpression();
-        }
+    if (!isTypeSpecifier(peek())) {
+        throw std::runtime_error("Expected declaration specifier found " +
+                                 std::string(lexeme(peek())));
+    }
+    std::optional<Expression> cond = std::nullopt;
+    std::optional<Expression> inc = std::nullopt;
+    // should parse the semicolon
+    auto decl = parseDeclaration();
+    if (peek().type != TokType::TOKEN_SEMICOLON) {
+        cond = parseExpression();
+        consume(TokType::TOKEN_SEMICOLON);
     } else {
-        throw std::runtime_error("Expected declaration specifier found " + peek().lexeme);
+        consume(TokType::TOKEN_SEMICOLON);
+    }
+    if (peek().type != TokType::TOKEN_RIGHT_PAREN) {
+        inc = parseExpression();
     }
     consume(TokType::TOKEN_RIGHT_PAREN);
     auto body = parseCompoundStatement();
-    auto bodyUnique = std::make_shared<st::CompoundStatement>(std::move(body));
-    return std::make_shared<st::ForStatement>(std::move(decl), std::move(cond), std::move(inc),
-                                              std::move(bodyUnique));
+    return builder.for_statement(std::move(decl), std::move(cond), std::move(inc),
+                                 std::move(body));
 }
 
 /**
@@ -369,91 +360,90 @@ auto parseForStatement() -> std::shared_ptr<st::ForStatement> {
  *      Not straight up. Needs to be requested from things like
  *        parseIfStatement() or parseForStatement()
  **/
-auto parseStatement() -> st::Statement {
+template <typename Builder>
+auto BasicParser<Builder>::parseStatement() -> Statement {
     if (match(TokType::TOKEN_RETURN)) {
-        auto ret = parseReturnStatement();
-        return st::Statement(std::move(ret));
+        return parseReturnStatement();
     }
     if (match(TokType::TOKEN_IF)) {
-        auto ifStmt = parseIfStatement();
-        return st::Statement(std::move(ifStmt));
+        return parseIfStatement();
     }
     if (match(TokType::TOKEN_FOR)) {
-        auto forStmt = parseForStatement();
-        return st::Statement(std::move(forStmt));
+        return parseForStatement();
     }
-    auto expr = parseExpressionStatement();
-    return st::Statement(std::move(expr));
+    return parseExpressionStatement();
 }
 
-st::BlockItem parseBlockItem() {
+template <typename Builder>
+auto BasicParser<Builder>::parseBlockItem() -> BlockItem {
     if (isStmtBegin(peek())) {
-        auto item = parseStatement();
-        return st::BlockItem(std::move(item));
+        return BlockItem(parseStatement());
     }
-    auto decl = parseDeclaration();
-    return st::BlockItem(std::move(decl));
+    return BlockItem(parseDeclaration());
 }
 
-st::CompoundStatement parseCompoundStatement() {
+template <typename Builder>
+auto BasicParser<Builder>::parseCompoundStatement() -> CompoundStatement {
     // left
     consume(TokType::TOKEN_LEFT_BRACE);
-    std::vector<st::BlockItem> blockItems;
+    const auto begin = pending<BlockItem>().size();
     while (!match(TokType::TOKEN_RIGHT_BRACE)) {
         auto bi = parseBlockItem();
-        blockItems.push_back(std::move(bi));
+        pending<BlockItem>().push_back(std::move(bi));
     }
-    return st::CompoundStatement{.items = std::move(blockItems)};
+    return finish_list<BlockItem>(
+        begin, [this](std::span<BlockItem> items) { return builder.block(items); });
 }
 
-st::Initalizer parseInitalizer() {
-    auto expr = parseExpression();
-    return st::Initalizer(std::move(expr));
-}
-
-st::InitDeclarator parseInitDeclarator() {
-    auto declarator = parseDeclarator();
+// the declared name is in scope from the end of its declarator, so before the initializer
+template <typename Builder>
+auto BasicParser<Builder>::parseInitDeclarator(st::NodeList<st::DeclarationSpecifier> declspecs)
+    -> Declaration {
+    const auto declarator = parseDeclarator();
+    auto declared = builder.declare(declspecs, declarator);
+    std::optional<Expression> initializer = std::nullopt;
     if (match(TokType::TOKEN_EQUAL)) {
-        auto initializer = parseInitalizer();
-        consume(TokType::TOKEN_SEMICOLON);
-        return st::InitDeclarator{.declarator = declarator, .initializer = std::move(initializer)};
+        builder.begin_initializer();
+        initializer = parseExpression();
     }
     consume(TokType::TOKEN_SEMICOLON);
-    return st::InitDeclarator{.declarator = declarator, .initializer = std::nullopt};
+    return builder.declaration(std::move(declared), std::move(initializer));
 }
 
-st::Declaration parseDeclaration() {
+template <typename Builder>
+auto BasicParser<Builder>::parseDeclaration() -> Declaration {
     const auto declspecs = parseDeclarationSpecs();
     // hack obvs
-    auto initDeclarator = parseInitDeclarator();
-    return st::Declaration{.declarationSpecifiers = declspecs,
-                           .initDeclarator = std::move(initDeclarator)};
+    return parseInitDeclarator(declspecs);
 }
 
-std::shared_ptr<st::FuncDef> parseFunctionDefinition() {
+template <typename Builder>
+auto BasicParser<Builder>::parseFunctionDefinition() -> ExternalDeclaration {
     const auto declspecs = parseDeclarationSpecs();
     const auto decl = parseDeclarator();
-    st::CompoundStatement body = parseCompoundStatement();
-    return std::make_shared<st::FuncDef>(declspecs, decl, std::move(body));
+    auto fn = builder.begin_function(declspecs, decl);
+    auto body = parseCompoundStatement();
+    return builder.function(std::move(fn), std::move(body));
 }
 
-std::optional<st::ExternalDeclaration> parseExternalDeclaration() {
-    const auto nxt = peek();
-    if (nxt.type == TokType::TOKEN_SEMICOLON) {
+template <typename Builder>
+auto BasicParser<Builder>::parseExternalDeclaration() -> std::optional<ExternalDeclaration> {
+    if (peek().type == TokType::TOKEN_SEMICOLON) {
         advance();
         return std::nullopt;
     }
-    if (isFuncBegin(peek(), peekn(1), peekn(2))) {
-        auto fd = parseFunctionDefinition();
-        return st::ExternalDeclaration(std::move(fd));
+    // furthest first: once it is buffered, looking closer cannot move the tokens referred to
+    const auto& third = peekn(2);
+    const auto& second = peekn(1);
+    if (isFuncBegin(peek(), second, third)) {
+        return parseFunctionDefinition();
     }
-    auto decl = parseDeclaration();
-    return st::ExternalDeclaration(std::move(decl));
+    return builder.external(parseDeclaration());
 }
 
-st::Program parse(const std::vector<Token>& tokens) {
-    g_tokens = tokens;
-    std::vector<st::ExternalDeclaration> nodes;
+template <typename Builder>
+auto BasicParser<Builder>::parseProgram() -> Program {
+    std::vector<ExternalDeclaration> nodes;
     while (isAtEnd() == false) {
         auto ed = parseExternalDeclaration();
         if (ed.has_value()) {
@@ -461,5 +451,69 @@ st::Program parse(const std::vector<Token>& tokens) {
             nodes.push_back(std::move(decl));
         }
     }
-    return st::Program(std::move(nodes));
-}
\ No newline at end of file
+    return builder.program(std::move(nodes));
+}
+
+template <typename Builder>
+auto BasicParser<Builder>::outlineProgram() -> std::vector<TokenRange> {
+    std::vector<TokenRange> ranges;
+    while (isAtEnd() == false) {
+        if (match(TokType::TOKEN_SEMICOLON)) {
+            continue;
+        }
+        const auto begin = stream.position();
+        // furthest first, as in parseExternalDeclaration()
+        const auto& third = peekn(2);
+        const auto& second = peekn(1);
+        if (isFuncBegin(peek(), second, third)) {
+            skipFunctionDefinition();
+        } else {
+            // declarations hold no braces and end at their first semicolon
+            while (!isAtEnd() && !match(TokType::TOKEN_SEMICOLON)) {
+                advance();
+            }
+        }
+        ranges.push_back(TokenRange{.begin = begin, .end = stream.position()});
+    }
+    return ranges;
+}
+
+// the body is the first brace after the declarator, which holds none, up to the matching one
+template <typename Builder>
+auto BasicParser<Builder>::skipFunctionDefinition() -> void {
+    while (!isAtEnd() && peek().type != TokType::TOKEN_LEFT_BRACE) {
+        advance();
+    }
+    std::size_t depth = 0;
+    while (!isAtEnd()) {
+        const auto type = advance().type;
+        if (type == TokType::TOKEN_LEFT_BRACE) {
+            depth++;
+        } else if (type == TokType::TOKEN_RIGHT_BRACE && --depth == 0) {
+            return;
+        }
+    }
+}
+
+template <typename Builder>
+auto BasicParser<Builder>::parseExternalDeclarations(std::span<const TokenRange> ranges)
+    -> Program {
+    std::vector<ExternalDeclaration> nodes;
+    nodes.reserve(ranges.size());
+    for (const auto& range : ranges) {
+        stream.seek(range.begin);
+        auto ed = parseExternalDeclaration();
+        if (!ed.has_value() || stream.position() != range.end) {
+            throw OutlineMismatch("External declaration does not end where outlined");
+        }
+        nodes.push_back(std::move(ed.value()));
+    }
+    return builder.program(std::move(nodes));
+}
+
+template class BasicParser<st::TreeBuilder>;
+template class BasicParser<ast::AstBuilder>;
+
+st::Program parse(const std::vector<Token>& tokens, std::string_view source) {
+    return Parser(tokens, source).parseProgram();
+}
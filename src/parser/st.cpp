@@ -2,65 +2,304 @@
 
 namespace st {
 AssignmentExpression::AssignmentExpression(Expression p_lhs, Expression p_rhs)
-    : lhs(std::move(p_lhs)), rhs(std::move(p_rhs)) {}
+    : lhs(p_lhs), rhs(p_rhs) {}
 
 AdditiveExpression::AdditiveExpression(Expression p_lhs, Expression p_rhs,
                                        AdditiveExpressionType p_type)
-    : lhs(std::move(p_lhs)), rhs(std::move(p_rhs)), type(p_type) {}
+    : lhs(p_lhs), rhs(p_rhs), type(p_type) {}
 
 MultiplicativeExpression::MultiplicativeExpression(Expression p_lhs, Expression p_rhs,
                                                    MultiplicativeExpressionType p_type)
-    : lhs(std::move(p_lhs)), rhs(std::move(p_rhs)), type(p_type) {}
+    : lhs(p_lhs), rhs(p_rhs), type(p_type) {}
 
-SelectionStatement::SelectionStatement(Expression p_cond, std::shared_ptr<CompoundStatement> p_then,
-                                       std::shared_ptr<CompoundStatement> p_else)
-    : cond(std::move(p_cond)), then(std::move(p_then)), else_(std::move(p_else)) {}
+SelectionStatement::SelectionStatement(Expression p_cond, CompoundStatement p_then,
+                                       std::optional<CompoundStatement> p_else)
+    : cond(p_cond), then(p_then), else_(p_else) {}
 
-Statement::Statement(
-    std::variant<std::shared_ptr<ExpressionStatement>, std::shared_ptr<ReturnStatement>,
-                 std::shared_ptr<SelectionStatement>, std::shared_ptr<ForStatement>>
-        p_stmt)
-    : stmt(std::move(p_stmt)) {}
-
-Statement::Statement(std::shared_ptr<ExpressionStatement> p_stmt) : stmt(std::move(p_stmt)) {}
-Statement::Statement(std::shared_ptr<ReturnStatement> p_stmt) : stmt(std::move(p_stmt)) {}
-Statement::Statement(std::shared_ptr<SelectionStatement> p_stmt) : stmt(std::move(p_stmt)) {}
-
-BlockItem::BlockItem(std::variant<Declaration, Statement> p_item) : item(std::move(p_item)) {}
-BlockItem::BlockItem(Declaration p_item) : item(std::move(p_item)) {}
-BlockItem::BlockItem(Statement p_item) : item(std::move(p_item)) {}
+BlockItem::BlockItem(std::variant<Declaration, Statement> p_item) : item(p_item) {}
+BlockItem::BlockItem(Declaration p_item) : item(p_item) {}
+BlockItem::BlockItem(Statement p_item) : item(p_item) {}
 
 UnaryExpression::UnaryExpression(UnaryExpressionType _type, Expression p_expr)
-    : type(_type), expr(std::move(p_expr)) {}
+    : type(_type), expr(p_expr) {}
 
-FunctionCallExpression::FunctionCallExpression(std::string p_name, std::vector<Expression> p_args)
-    : name(std::move(p_name)), args(std::move(p_args)) {}
+FunctionCallExpression::FunctionCallExpression(std::string_view p_name,
+                                               NodeList<Expression> p_args)
+    : name(p_name), args(p_args) {}
 
 ForStatement::ForStatement(ForDeclaration p_init, std::optional<Expression> p_cond,
-                           std::optional<Expression> p_inc,
-                           std::shared_ptr<CompoundStatement> p_body)
-    :
+                           std::optional<Expression> p_inc, CompoundStatement p_body)
+    : init(p_init), cond(p_cond), inc(p_inc), body(p_body) {}
+
+ArrayAccessExpression::ArrayAccessExpression(std::string_view p_name, Expression p_index)
+    : name(p_name), index(p_index) {}
+
+namespace {
+
+auto print(std::ostream& os, const Tree& tree, const std::optional<InitDeclarator>& node)
+    -> std::ostream& {
+    if (!node) {
+        return os << "nullptr";
+    }
+    os << "InitDeclarator(declarator=" << node->declarator << ", initializer=";
+    if (node->initializer) {
+        os << "Initalizer(expr=";
+        print(os, tree, node->initializer->expr) << ")";
+    } else {
+        os << "nullptr";
+    }
+    return os << ")";
+}
+
+auto print(std::ostream& os, const Tree& tree, NodeList<DeclarationSpecifier> specifiers)
+    -> std::ostream& {
+    os << "declarationSpecifiers=[";
+    for (const auto& v : tree.list(specifiers)) {
+        os << v << ",";
+    }
+    return os << "]";
+}
+
+// calls, array accesses and divisions have never been printed
+auto print_node(std::ostream& os, const Tree&, const PrimaryExpression& node) -> std::ostream& {
+    return os << node;
+}
+
+auto print_node(std::ostream& os, const Tree& tree, const AssignmentExpression& node)
+    -> std::ostream& {
+    os << "AssignmentExpression(lhs=";
+    print(os, tree, node.lhs) << ", rhs=";
+    return print(os, tree, node.rhs) << ")";
+}
+
+auto print_node(std::ostream& os, const Tree& tree, const UnaryExpression& node)
+    -> std::ostream& {
+    os << "UnaryExpression(type=" << (node.type == UnaryExpressionType::DEREF ? "DEREF" : "ADDR")
+       << ", expr=";
+    return print(os, tree, node.expr) << ")";
+}
+
+auto print_node(std::ostream& os, const Tree& tree, const AdditiveExpression& node)
+    -> std::ostream& {
+    os << "AdditiveExpression(lhs=";
+    print(os, tree, node.lhs) << ", rhs=";
+    return print(os, tree, node.rhs) << ")";
+}
+
+auto print_node(std::ostream& os, const Tree&, const FunctionCallExpression&) -> std::ostream& {
+    return os;
+}
 
-      init(std::move(p_init)),
-      cond(std::move(p_cond)),
-      inc(std::move(p_inc)),
+auto print_node(std::ostream& os, const Tree&, const ArrayAccessExpression&) -> std::ostream& {
+    return os;
+}
 
-      body(std::move(p_body)) {}
+auto print_node(std::ostream& os, const Tree&, const MultiplicativeExpression&)
+    -> std::ostream& {
+    return os;
+}
 
-ArrayAccessExpression::ArrayAccessExpression(std::string p_name, Expression p_index)
-    : name(std::move(p_name)), index(std::move(p_index)) {}
+auto print_node(std::ostream& os, const Tree& tree, const ExpressionStatement& node)
+    -> std::ostream& {
+    os << "ExpressionStatement(expr=";
+    return print(os, tree, node.expr) << ")";
+}
 
-std::ostream& ForStatement::print(std::ostream& os) const {
-    os << "Forstatement(";
-    init.print(os);
-    if (cond.has_value()) {
-        os << cond.value();
+auto print_node(std::ostream& os, const Tree& tree, const ReturnStatement& node)
+    -> std::ostream& {
+    os << "ReturnStatement(expr=";
+    return print(os, tree, node.expr) << ")";
+}
+
+auto print_node(std::ostream& os, const Tree& tree, const SelectionStatement& node)
+    -> std::ostream& {
+    os << "SelectionStatement(cond=";
+    print(os, tree, node.cond) << ", then=";
+    print(os, tree, node.then) << ", else=";
+    if (node.else_) {
+        print(os, tree, *node.else_);
+    } else {
+        os << "nullptr";
+    }
+    return os << ")";
+}
+
+auto print_node(std::ostream& os, const Tree& tree, const ForStatement& node) -> std::ostream& {
+    os << "Forstatement(ForDeclaration(";
+    print(os, tree, node.init.declarationSpecifiers) << ", initDeclarator=";
+    print(os, tree, node.init.initDeclarator) << ")";
+    if (node.cond.has_value()) {
+        print(os, tree, *node.cond);
+    }
+    if (node.inc.has_value()) {
+        print(os, tree, *node.inc);
     }
-    if (inc.has_value()) {
-        os << inc.value();
+    return print(os, tree, node.body);
+}
+
+}  // namespace
+
+auto print(std::ostream& os, const Tree& tree, Expression expr) -> std::ostream& {
+    return tree.visit([&](const auto& node) -> std::ostream& { return print_node(os, tree, node); },
+                      expr);
+}
+
+auto print(std::ostream& os, const Tree& tree, Statement stmt) -> std::ostream& {
+    os << "Statement(";
+    tree.visit([&](const auto& node) -> std::ostream& { return print_node(os, tree, node); },
+               stmt);
+    return os << "))";
+}
+
+auto print(std::ostream& os, const Tree& tree, const CompoundStatement& node) -> std::ostream& {
+    os << "CompoundStatement(items=[";
+    for (const auto& v : tree.list(node.items)) {
+        if (std::holds_alternative<Declaration>(v.item)) {
+            print(os, tree, std::get<Declaration>(v.item)) << std::endl;
+        } else {
+            print(os, tree, std::get<Statement>(v.item)) << std::endl;
+        }
+        os << "\n";
     }
-    body->print(os);
+    os << "])";
     return os;
 }
 
+auto print(std::ostream& os, const Tree& tree, const Declaration& node) -> std::ostream& {
+    os << "Declaration(";
+    print(os, tree, node.declarationSpecifiers) << ", initDeclarator=";
+    return print(os, tree, node.initDeclarator) << ")";
+}
+
+auto print(std::ostream& os, const Tree& tree, const ExternalDeclaration& node) -> std::ostream& {
+    if (std::holds_alternative<Declaration>(node.node)) {
+        const auto& decl = std::get<Declaration>(node.node);
+        os << "ExternalDeclaration(Declaration(";
+        print(os, tree, decl.declarationSpecifiers) << ", initDeclarator=";
+        print(os, tree, decl.initDeclarator);
+    } else {
+        const auto& funcdef = std::get<FuncDef>(node.node);
+        os << "ExternalDeclaration(FuncDef(";
+        print(os, tree, funcdef.declarationSpecifiers)
+            << "\n, declarator=" << funcdef.declarator << "\n, body=";
+        print(os, tree, funcdef.body);
+    }
+    return os;
+}
+
+namespace {
+
+[[nodiscard]] auto count_nodes(const Tree& tree, Expression expr) -> std::size_t;
+[[nodiscard]] auto count_nodes(const Tree& tree, const CompoundStatement& stmt) -> std::size_t;
+
+[[nodiscard]] auto count_node(const Tree&, const PrimaryExpression&) -> std::size_t { return 1; }
+
+[[nodiscard]] auto count_node(const Tree& tree, const AssignmentExpression& expr) -> std::size_t {
+    return 1 + count_nodes(tree, expr.lhs) + count_nodes(tree, expr.rhs);
+}
+
+[[nodiscard]] auto count_node(const Tree& tree, const UnaryExpression& expr) -> std::size_t {
+    return 1 + count_nodes(tree, expr.expr);
+}
+
+[[nodiscard]] auto count_node(const Tree& tree, const AdditiveExpression& expr) -> std::size_t {
+    return 1 + count_nodes(tree, expr.lhs) + count_nodes(tree, expr.rhs);
+}
+
+[[nodiscard]] auto count_node(const Tree& tree, const MultiplicativeExpression& expr)
+    -> std::size_t {
+    return 1 + count_nodes(tree, expr.lhs) + count_nodes(tree, expr.rhs);
+}
+
+[[nodiscard]] auto count_node(const Tree& tree, const FunctionCallExpression& expr)
+    -> std::size_t {
+    std::size_t count = 1;
+    for (const auto arg : tree.list(expr.args)) {
+        count += count_nodes(tree, arg);
+    }
+    return count;
+}
+
+[[nodiscard]] auto count_node(const Tree& tree, const ArrayAccessExpression& expr)
+    -> std::size_t {
+    return 1 + count_nodes(tree, expr.index);
+}
+
+auto count_nodes(const Tree& tree, Expression expr) -> std::size_t {
+    return tree.visit([&tree](const auto& node) { return count_node(tree, node); }, expr);
+}
+
+[[nodiscard]] auto count_nodes(const Tree& tree, const std::optional<InitDeclarator>& init)
+    -> std::size_t {
+    if (!init.has_value()) {
+        return 0;
+    }
+    std::size_t count = 1;
+    const auto& dd = init->declarator.directDeclarator;
+    if (dd.kind == DeclaratorKind::ARRAY) {
+        count += count_nodes(tree, std::get<ArrayDirectDeclarator>(dd.declarator).size);
+    }
+    if (init->initializer.has_value()) {
+        count += count_nodes(tree, init->initializer->expr);
+    }
+    return count;
+}
+
+[[nodiscard]] auto count_node(const Tree& tree, const ExpressionStatement& stmt) -> std::size_t {
+    return 1 + count_nodes(tree, stmt.expr);
+}
+
+[[nodiscard]] auto count_node(const Tree& tree, const ReturnStatement& stmt) -> std::size_t {
+    return 1 + count_nodes(tree, stmt.expr);
+}
+
+[[nodiscard]] auto count_node(const Tree& tree, const SelectionStatement& stmt) -> std::size_t {
+    auto count = 1 + count_nodes(tree, stmt.cond) + count_nodes(tree, stmt.then);
+    if (stmt.else_) {
+        count += count_nodes(tree, *stmt.else_);
+    }
+    return count;
+}
+
+[[nodiscard]] auto count_node(const Tree& tree, const ForStatement& stmt) -> std::size_t {
+    auto count =
+        1 + count_nodes(tree, stmt.init.initDeclarator) + count_nodes(tree, stmt.body);
+    if (stmt.cond.has_value()) {
+        count += count_nodes(tree, *stmt.cond);
+    }
+    if (stmt.inc.has_value()) {
+        count += count_nodes(tree, *stmt.inc);
+    }
+    return count;
+}
+
+auto count_nodes(const Tree& tree, const CompoundStatement& stmt) -> std::size_t {
+    std::size_t count = 1;
+    for (const auto& bi : tree.list(stmt.items)) {
+        if (std::holds_alternative<Declaration>(bi.item)) {
+            count += 1 + count_nodes(tree, std::get<Declaration>(bi.item).initDeclarator);
+        } else {
+            count += tree.visit([&tree](const auto& node) { return count_node(tree, node); },
+                                std::get<Statement>(bi.item));
+        }
+    }
+    return count;
+}
+
+}  // namespace
+
+auto count_nodes(const Program& program) -> std::size_t {
+    std::size_t count = 1;
+    for (const auto& ed : program.nodes) {
+        if (std::holds_alternative<Declaration>(ed.node)) {
+            count += 1 + count_nodes(program.tree, std::get<Declaration>(ed.node).initDeclarator);
+        } else {
+            const auto& funcdef = std::get<FuncDef>(ed.node);
+            count += 1 + funcdef.DirectDeclarator().params.params.count +
+                     count_nodes(program.tree, funcdef.body);
+        }
+    }
+    return count;
+}
+
 }  // namespace st
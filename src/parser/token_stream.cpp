@@ -0,0 +1,55 @@
+#include "../../include/parser/token_stream.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+// a power of two, which covers the lookahead of ordinary statements
+constexpr std::size_t initial_ring_size = 64;
+}  // namespace
+
+TokenStream::TokenStream(std::span<const Token> p_tokens) : tokens(p_tokens) {}
+
+TokenStream::TokenStream(std::string_view source)
+    : lexer(std::in_place, source), ring(initial_ring_size) {}
+
+auto TokenStream::advance() -> Token {
+    const auto tk = peek();
+    if (tk.type != TokType::TOKEN_FEOF) {
+        current++;
+    }
+    return tk;
+}
+
+void TokenStream::seek(std::size_t position) {
+    if (lexer.has_value()) {
+        throw std::logic_error("Cannot seek in tokens that are lexed while parsing");
+    }
+    current = std::min(position, tokens.size());
+}
+
+auto TokenStream::previous() const -> const Token& {
+    return lexer.has_value() ? at(current - 1) : tokens[current - 1];
+}
+
+// lexes up to and including token `index`, dropping what is behind the previous token
+void TokenStream::fill(std::size_t index) {
+    first = std::max(first, current == 0 ? 0 : current - 1);
+    while (end <= index) {
+        if (end - first == ring.size()) {
+            grow();
+        }
+        ring[end & (ring.size() - 1)] = lexer->next();
+        end++;
+    }
+    peak = std::max(peak, end - first);
+}
+
+void TokenStream::grow() {
+    std::vector<Token> larger(ring.size() * 2);
+    for (auto i = first; i < end; i++) {
+        larger[i & (larger.size() - 1)] = at(i);
+    }
+    ring = std::move(larger);
+}
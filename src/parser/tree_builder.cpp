@@ -0,0 +1,118 @@
+#include "../../include/parser/tree_builder.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace st {
+
+// calls and array accesses are only supported on names
+auto TreeBuilder::callee_name(Expression callee) const -> std::string_view {
+    if (callee.kind != ExpressionKind::PRIMARY) {
+        throw std::runtime_error("Expected a name before '(' or '['");
+    }
+    return tree.get<PrimaryExpression>(callee).idenValue;
+}
+
+auto TreeBuilder::call(std::string_view name, std::span<Expression> args) -> Expression {
+    return tree.add_expression(FunctionCallExpression(name, tree.add_list<Expression>(args)));
+}
+
+auto TreeBuilder::array_access(std::string_view name, Expression index) -> Expression {
+    return tree.add_expression(ArrayAccessExpression(name, index));
+}
+
+auto TreeBuilder::unary(UnaryExpressionType type, Expression operand) -> Expression {
+    return tree.add_expression(UnaryExpression(type, operand));
+}
+
+auto TreeBuilder::binary(BinaryOp op, Expression lhs, Expression rhs) -> Expression {
+    const auto additive = [&](AdditiveExpressionType type) {
+        return tree.add_expression(AdditiveExpression(lhs, rhs, type));
+    };
+    const auto multiplicative = [&](MultiplicativeExpressionType type) {
+        return tree.add_expression(MultiplicativeExpression(lhs, rhs, type));
+    };
+    switch (op) {
+        case BinaryOp::ASSIGN:
+            return tree.add_expression(AssignmentExpression(lhs, rhs));
+        case BinaryOp::EQ:
+            return additive(AdditiveExpressionType::EQ);
+        case BinaryOp::NEQ:
+            return additive(AdditiveExpressionType::NEQ);
+        case BinaryOp::LT:
+            return additive(AdditiveExpressionType::LT);
+        case BinaryOp::GT:
+            return additive(AdditiveExpressionType::GT);
+        case BinaryOp::ADD:
+            return additive(AdditiveExpressionType::ADD);
+        case BinaryOp::SUB:
+            return additive(AdditiveExpressionType::SUB);
+        case BinaryOp::MUL:
+            return multiplicative(MultiplicativeExpressionType::Mult);
+        case BinaryOp::DIV:
+            return multiplicative(MultiplicativeExpressionType::Div);
+        case BinaryOp::NONE:
+            break;
+    }
+    throw std::logic_error("not a binary operator");
+}
+
+auto TreeBuilder::return_statement(Expression expr) -> Statement {
+    return tree.add_statement(ReturnStatement(expr));
+}
+
+auto TreeBuilder::expression_statement(Expression expr) -> Statement {
+    return tree.add_statement(ExpressionStatement(expr));
+}
+
+auto TreeBuilder::if_statement(Expression cond, CompoundStatement then,
+                               std::optional<CompoundStatement> else_) -> Statement {
+    return tree.add_statement(SelectionStatement(cond, then, else_));
+}
+
+auto TreeBuilder::for_statement(const Declaration& init, std::optional<Expression> cond,
+                                std::optional<Expression> inc, CompoundStatement body)
+    -> Statement {
+    const ForDeclaration decl(init.declarationSpecifiers, init.initDeclarator);
+    return tree.add_statement(ForStatement(decl, cond, inc, body));
+}
+
+auto TreeBuilder::block(std::span<BlockItem> items) -> CompoundStatement {
+    return CompoundStatement{.items = tree.add_list<BlockItem>(items)};
+}
+
+auto TreeBuilder::declare(NodeList<DeclarationSpecifier> specifiers, const Declarator& declarator)
+    -> Declaration {
+    return Declaration{
+        .declarationSpecifiers = specifiers,
+        .initDeclarator = InitDeclarator{.declarator = declarator, .initializer = std::nullopt},
+    };
+}
+
+auto TreeBuilder::declaration(Declaration declared, std::optional<Expression> initializer)
+    -> Declaration {
+    if (initializer.has_value()) {
+        declared.initDeclarator->initializer = Initalizer(*initializer);
+    }
+    return declared;
+}
+
+auto TreeBuilder::begin_function(NodeList<DeclarationSpecifier> specifiers,
+                                 const Declarator& declarator) -> FuncDef {
+    return FuncDef(specifiers, declarator, CompoundStatement{});
+}
+
+auto TreeBuilder::function(FuncDef fd, CompoundStatement body) -> ExternalDeclaration {
+    fd.body = body;
+    return ExternalDeclaration(fd);
+}
+
+auto TreeBuilder::external(Declaration decl) -> ExternalDeclaration {
+    return ExternalDeclaration(decl);
+}
+
+auto TreeBuilder::program(std::vector<ExternalDeclaration> nodes) -> Program {
+    return Program(std::move(tree), std::move(nodes));
+}
+
+}  // namespace st
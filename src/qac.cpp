@@ -0,0 +1,34 @@
+#include "../include/qac.hpp"
+
+#include <stdexcept>
+
+#include "../include/driver.hpp"
+#include "../include/support/thread_pool.hpp"
+
+namespace qac {
+
+auto compile(std::string_view source, const Options& options) -> CompileResult {
+    support::ThreadPool pool(options.jobs);
+    return compile(source, options, pool);
+}
+
+auto compile(std::string_view source, const Options& options, support::ThreadPool& pool)
+    -> CompileResult {
+    support::TimeReport report(options.time_report, options.source_name);
+    DriverOptions driver_options;
+    driver_options.jobs = static_cast<unsigned>(pool.size());
+    driver_options.fused_front_end = options.fused_front_end;
+    driver_options.parallel_front_end = options.parallel_front_end;
+
+    CompileResult result;
+    try {
+        result.assembly = compile_to_assembly(source, driver_options, "", report, pool);
+        result.ok = true;
+    } catch (const std::exception& e) {
+        result.diagnostics = options.source_name + ": error: " + e.what() + "\n";
+    }
+    result.phases = report.get_phases();
+    return result;
+}
+
+}  // namespace qac
@@ -0,0 +1,272 @@
+#include "../include/server.hpp"
+
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "../include/qac.hpp"
+#include "../include/support/source_buffer.hpp"
+#include "../include/support/thread_pool.hpp"
+#include "../include/support/time_report.hpp"
+
+namespace server {
+
+namespace {
+
+// refuse absurd lengths from a confused peer instead of trying to allocate them
+constexpr std::uint32_t max_message_size = 1u << 30;
+// a client that stops sending its request or reading the reply for this long is dropped, so it
+// cannot hold on to one of the server's threads
+constexpr std::chrono::seconds io_timeout{30};
+
+[[nodiscard]] auto system_error(const std::string& what) -> std::runtime_error {
+    return std::runtime_error(what + ": " + strerror(errno));
+}
+
+// Closes the descriptor when it goes out of scope.
+class Socket {
+   public:
+    explicit Socket(int p_fd) : fd(p_fd) {
+        if (fd < 0) {
+            throw system_error("socket");
+        }
+    }
+    ~Socket() { close(fd); }
+    Socket(const Socket&) = delete;
+    auto operator=(const Socket&) -> Socket& = delete;
+
+    [[nodiscard]] auto get() const -> int { return fd; }
+
+   private:
+    int fd;
+};
+
+[[nodiscard]] auto socket_address(const std::string& path) -> sockaddr_un {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("socket path too long: " + path);
+    }
+    path.copy(address.sun_path, path.size());
+    return address;
+}
+
+void send_all(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        // MSG_NOSIGNAL: a client hanging up must not kill the server with SIGPIPE
+        const auto sent = send(fd, data, size, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                throw std::runtime_error("send timed out");
+            }
+            throw system_error("send");
+        }
+        data += sent;
+        size -= static_cast<std::size_t>(sent);
+    }
+}
+
+void receive_all(int fd, char* data, std::size_t size) {
+    while (size > 0) {
+        const auto received = recv(fd, data, size, 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            throw std::runtime_error("recv timed out");
+        }
+        if (received < 0) {
+            throw system_error("recv");
+        }
+        if (received == 0) {
+            throw std::runtime_error("connection closed mid message");
+        }
+        data += received;
+        size -= static_cast<std::size_t>(received);
+    }
+}
+
+void send_string(int fd, std::string_view s) {
+    if (s.size() > max_message_size) {
+        throw std::runtime_error("message too large");
+    }
+    const auto size = static_cast<std::uint32_t>(s.size());
+    const unsigned char header[4] = {
+        static_cast<unsigned char>(size), static_cast<unsigned char>(size >> 8),
+        static_cast<unsigned char>(size >> 16), static_cast<unsigned char>(size >> 24)};
+    send_all(fd, reinterpret_cast<const char*>(header), sizeof(header));
+    send_all(fd, s.data(), s.size());
+}
+
+[[nodiscard]] auto receive_string(int fd) -> std::string {
+    unsigned char header[4];
+    receive_all(fd, reinterpret_cast<char*>(header), sizeof(header));
+    const std::uint32_t size = header[0] | header[1] << 8 | header[2] << 16 |
+                               static_cast<std::uint32_t>(header[3]) << 24;
+    if (size > max_message_size) {
+        throw std::runtime_error("message too large");
+    }
+    std::string s(size, '\0');
+    receive_all(fd, s.data(), s.size());
+    return s;
+}
+
+void set_timeouts(int fd) {
+    const timeval timeout = {.tv_sec = io_timeout.count(), .tv_usec = 0};
+    if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) < 0 ||
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) < 0) {
+        throw system_error("setsockopt");
+    }
+}
+
+void handle_connection(int fd, support::ThreadPool& pool) {
+    qac::Options options;
+    options.source_name = receive_string(fd);
+    const auto source = receive_string(fd);
+    options.time_report = receive_string(fd) == "1";
+    options.fused_front_end = receive_string(fd) == "1";
+    options.parallel_front_end = receive_string(fd) == "1";
+
+    const auto result = qac::compile(source, options, pool);
+    auto diagnostics = result.diagnostics;
+    if (options.time_report) {
+        support::TimeReport report(true, options.source_name);
+        for (const auto& phase : result.phases) {
+            report.add(phase);
+        }
+        std::ostringstream os;
+        report.print(os);
+        diagnostics += os.str();
+    }
+
+    send_string(fd, result.ok ? "0" : "1");
+    send_string(fd, result.assembly);
+    send_string(fd, diagnostics);
+}
+
+void accept_loop(int listen_fd, support::ThreadPool& pool) {
+    while (true) {
+        const int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            std::cerr << "qac server: " << system_error("accept").what() << "\n";
+            return;
+        }
+        Socket connection(fd);
+        try {
+            set_timeouts(connection.get());
+            handle_connection(connection.get(), pool);
+        } catch (const std::exception& e) {
+            std::cerr << "qac server: " << e.what() << "\n";
+        }
+    }
+}
+
+// Removes a socket file left behind by a previous server that was killed. Anything else at
+// `path`, a file that is not a socket or a socket a server still listens on, is an error.
+void remove_stale_socket(const std::string& path, const sockaddr_un& address) {
+    struct stat status = {};
+    if (lstat(path.c_str(), &status) < 0) {
+        if (errno == ENOENT) {
+            return;
+        }
+        throw system_error("lstat " + path);
+    }
+    if (!S_ISSOCK(status.st_mode)) {
+        throw std::runtime_error("not a socket: " + path);
+    }
+    Socket probe(socket(AF_UNIX, SOCK_STREAM, 0));
+    if (connect(probe.get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0) {
+        throw std::runtime_error("socket in use: " + path);
+    }
+    if (errno != ECONNREFUSED) {
+        throw system_error("connect " + path);
+    }
+    if (unlink(path.c_str()) < 0) {
+        throw system_error("unlink " + path);
+    }
+}
+
+}  // namespace
+
+int serve(const std::string& socket_path, unsigned threads) {
+    try {
+        Socket listener(socket(AF_UNIX, SOCK_STREAM, 0));
+        const auto address = socket_address(socket_path);
+        remove_stale_socket(socket_path, address);
+        if (bind(listener.get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) <
+            0) {
+            throw system_error("bind " + socket_path);
+        }
+        if (listen(listener.get(), SOMAXCONN) < 0) {
+            throw system_error("listen");
+        }
+
+        // every thread blocks in accept() on the same socket, the kernel hands each new
+        // connection to one of them
+        support::ThreadPool pool(threads);
+        std::vector<std::thread> acceptors;
+        for (unsigned i = 1; i < threads; i++) {
+            acceptors.emplace_back(accept_loop, listener.get(), std::ref(pool));
+        }
+        accept_loop(listener.get(), pool);
+        for (auto& acceptor : acceptors) {
+            acceptor.join();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "qac server: " << e.what() << "\n";
+    }
+    return EXIT_FAILURE;
+}
+
+int compile_remote(const std::string& socket_path, const char* sourcefile,
+                   const std::string& outfile, const DriverOptions& options) {
+    try {
+        Socket connection(socket(AF_UNIX, SOCK_STREAM, 0));
+        const auto address = socket_address(socket_path);
+        if (connect(connection.get(), reinterpret_cast<const sockaddr*>(&address),
+                    sizeof(address)) < 0) {
+            throw system_error("connect " + socket_path);
+        }
+
+        send_string(connection.get(), sourcefile);
+        send_string(connection.get(), support::SourceBuffer::open(sourcefile).view());
+        send_string(connection.get(), options.time_report ? "1" : "0");
+        send_string(connection.get(), options.fused_front_end ? "1" : "0");
+        send_string(connection.get(), options.parallel_front_end ? "1" : "0");
+
+        const auto status = receive_string(connection.get());
+        const auto assembly = receive_string(connection.get());
+        std::cerr << receive_string(connection.get());
+        if (status != "0") {
+            return EXIT_FAILURE;
+        }
+        write_to_file(assembly, outfile);
+        return EXIT_SUCCESS;
+    } catch (const std::exception& e) {
+        std::cerr << sourcefile << ": error: " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+}
+
+}  // namespace server
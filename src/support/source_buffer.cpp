@@ -0,0 +1,112 @@
+#include "../../include/support/source_buffer.hpp"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <utility>
+
+namespace support {
+
+namespace {
+
+[[nodiscard]] auto read_error(const char* path) -> std::runtime_error {
+    return std::runtime_error(std::string("could not read ") + path + ": " + strerror(errno));
+}
+
+// reads until end of file, growing the buffer geometrically
+[[nodiscard]] auto read_all(int fd, const char* path, std::size_t size_hint) -> std::string {
+    std::string contents(std::max<std::size_t>(size_hint, 4096), '\0');
+    std::size_t used = 0;
+    while (true) {
+        if (used == contents.size()) {
+            contents.resize(contents.size() * 2);
+        }
+        const auto n = read(fd, contents.data() + used, contents.size() - used);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            throw read_error(path);
+        }
+        if (n == 0) {
+            break;
+        }
+        used += static_cast<std::size_t>(n);
+    }
+    contents.resize(used);
+    return contents;
+}
+
+}  // namespace
+
+auto SourceBuffer::open(const char* path) -> SourceBuffer {
+    SourceBuffer buffer;
+    if (std::string_view(path) == "-") {
+        buffer.owned = read_all(STDIN_FILENO, "stdin", 0);
+        return buffer;
+    }
+
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw read_error(path);
+    }
+    struct stat info = {};
+    if (fstat(fd, &info) < 0) {
+        const auto error = read_error(path);
+        close(fd);
+        throw error;
+    }
+
+    const auto size = static_cast<std::size_t>(info.st_size);
+    if (S_ISREG(info.st_mode) && size > 0) {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            // the lexer makes a single forward pass
+            madvise(mapping, size, MADV_SEQUENTIAL);
+            close(fd);
+            buffer.mapping = mapping;
+            buffer.size = size;
+            return buffer;
+        }
+    }
+
+    try {
+        buffer.owned = read_all(fd, path, S_ISREG(info.st_mode) ? size : 0);
+    } catch (...) {
+        close(fd);
+        throw;
+    }
+    close(fd);
+    return buffer;
+}
+
+SourceBuffer::SourceBuffer(SourceBuffer&& other) noexcept
+    : mapping(std::exchange(other.mapping, nullptr)),
+      size(std::exchange(other.size, 0)),
+      owned(std::move(other.owned)) {}
+
+auto SourceBuffer::operator=(SourceBuffer&& other) noexcept -> SourceBuffer& {
+    if (this != &other) {
+        if (mapping != nullptr) {
+            munmap(mapping, size);
+        }
+        mapping = std::exchange(other.mapping, nullptr);
+        size = std::exchange(other.size, 0);
+        owned = std::move(other.owned);
+    }
+    return *this;
+}
+
+SourceBuffer::~SourceBuffer() {
+    if (mapping != nullptr) {
+        munmap(mapping, size);
+    }
+}
+
+}  // namespace support
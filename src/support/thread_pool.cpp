@@ -0,0 +1,76 @@
+#include "../../include/support/thread_pool.hpp"
+
+namespace support {
+
+ThreadPool::ThreadPool(unsigned threads) {
+    for (unsigned i = 1; i < threads; i++) {
+        workers.emplace_back([this] { worker_loop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    task_available.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+    {
+        std::lock_guard lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    task_available.notify_one();
+}
+
+void ThreadPool::worker_loop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(mutex);
+            task_available.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::Job::run() {
+    for (auto i = next++; i < count; i = next++) {
+        std::exception_ptr thrown = nullptr;
+        try {
+            body(i);
+        } catch (...) {
+            thrown = std::current_exception();
+        }
+        std::lock_guard lock(mutex);
+        if (thrown && !error) {
+            error = thrown;
+        }
+        if (++finished == count) {
+            all_done.notify_all();
+        }
+    }
+}
+
+void ThreadPool::Job::wait() {
+    std::unique_lock lock(mutex);
+    all_done.wait(lock, [this] { return finished == count; });
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+auto default_thread_count() -> unsigned {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+}  // namespace support
@@ -0,0 +1,153 @@
+#include "../../include/support/time_report.hpp"
+
+#include <sys/resource.h>
+#include <time.h>
+
+#include <cstdio>
+
+namespace support {
+
+namespace {
+
+[[nodiscard]] auto clock_ms(clockid_t clock) -> double {
+    timespec ts{};
+    clock_gettime(clock, &ts);
+    return static_cast<double>(ts.tv_sec) * 1e3 + static_cast<double>(ts.tv_nsec) / 1e6;
+}
+
+void print_json_string(std::ostream& os, std::string_view s) {
+    os << '"';
+    for (const char c : s) {
+        if (c == '"' || c == '\\') {
+            os << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            os << escaped;
+        } else {
+            os << c;
+        }
+    }
+    os << '"';
+}
+
+[[nodiscard]] auto total_of(const std::vector<PhaseRecord>& phases) -> PhaseRecord {
+    PhaseRecord total{.name = "total"};
+    for (const auto& phase : phases) {
+        total.wall_ms += phase.wall_ms;
+        total.cpu_ms += phase.cpu_ms;
+        if (phase.cpu_clock == CpuClock::Process) {
+            total.cpu_clock = CpuClock::Process;
+        }
+        total.peak_rss_delta_kib += phase.peak_rss_delta_kib;
+    }
+    return total;
+}
+
+void print_row(std::ostream& os, const PhaseRecord& phase) {
+    char row[160];
+    snprintf(row, sizeof(row), "  %-12s %12.3f %12.3f%c %23ld", phase.name.c_str(), phase.wall_ms,
+             phase.cpu_ms, phase.cpu_clock == CpuClock::Process ? '*' : ' ',
+             phase.peak_rss_delta_kib);
+    os << row;
+    if (!phase.object_kind.empty()) {
+        os << "  " << phase.objects << " " << phase.object_kind;
+    }
+    os << '\n';
+}
+
+void print_json_phase(std::ostream& os, const PhaseRecord& phase) {
+    os << "{\"name\": ";
+    print_json_string(os, phase.name);
+    os << ", \"wall_ms\": " << phase.wall_ms << ", \"cpu_ms\": " << phase.cpu_ms
+       << ", \"cpu_clock\": \"" << (phase.cpu_clock == CpuClock::Process ? "process" : "thread")
+       << "\", \"process_peak_rss_delta_kib\": " << phase.peak_rss_delta_kib;
+    if (!phase.object_kind.empty()) {
+        os << ", \"objects\": " << phase.objects << ", \"object_kind\": ";
+        print_json_string(os, phase.object_kind);
+    }
+    os << "}";
+}
+
+}  // namespace
+
+auto wall_clock_ms() -> double { return clock_ms(CLOCK_MONOTONIC); }
+
+auto cpu_clock_ms(CpuClock clock) -> double {
+    return clock_ms(clock == CpuClock::Process ? CLOCK_PROCESS_CPUTIME_ID
+                                               : CLOCK_THREAD_CPUTIME_ID);
+}
+
+auto peak_rss_kib() -> long {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    // ru_maxrss is reported in KiB on Linux
+    return usage.ru_maxrss;
+}
+
+auto ClockSample::now(CpuClock cpu_clock) -> ClockSample {
+    return ClockSample{.wall_ms = wall_clock_ms(),
+                       .cpu_ms = cpu_clock_ms(cpu_clock),
+                       .peak_rss_kib = support::peak_rss_kib()};
+}
+
+PhaseTimer::PhaseTimer(TimeReport& p_report, std::string_view p_name, CpuClock p_cpu_clock)
+    : report(p_report),
+      name(p_name),
+      cpu_clock(p_cpu_clock),
+      enabled(p_report.is_enabled()),
+      span(p_name) {
+    if (enabled) {
+        start = ClockSample::now(cpu_clock);
+    }
+}
+
+void PhaseTimer::record(const ClockSample& end, std::string_view object_kind,
+                        std::size_t objects) {
+    report.get().add(PhaseRecord{
+        .name = name,
+        .wall_ms = end.wall_ms - start.wall_ms,
+        .cpu_ms = end.cpu_ms - start.cpu_ms,
+        .cpu_clock = cpu_clock,
+        .peak_rss_delta_kib = end.peak_rss_kib - start.peak_rss_kib,
+        .objects = objects,
+        .object_kind = std::string(object_kind),
+    });
+}
+
+void TimeReport::print(std::ostream& os) const {
+    os << "qac time report for " << file << "\n";
+    os << "  phase           wall (ms)     cpu (ms)  process peak rss +(KiB)  produced\n";
+    for (const auto& phase : phases) {
+        print_row(os, phase);
+    }
+    const auto total = total_of(phases);
+    print_row(os, total);
+    if (total.cpu_clock == CpuClock::Process) {
+        os << "  * cpu time of the whole process, including the thread pool\n";
+    }
+    for (const auto& [counter, value] : counters) {
+        os << "  " << counter << ": " << value << "\n";
+    }
+}
+
+void TimeReport::print_json(std::ostream& os) const {
+    os << "{\"file\": ";
+    print_json_string(os, file);
+    os << ", \"process_peak_rss_kib\": " << peak_rss_kib() << ", \"phases\": [";
+    for (std::size_t i = 0; i < phases.size(); i++) {
+        os << (i == 0 ? "" : ", ");
+        print_json_phase(os, phases[i]);
+    }
+    os << "], \"total\": ";
+    print_json_phase(os, total_of(phases));
+    os << ", \"counters\": {";
+    for (auto it = counters.begin(); it != counters.end(); ++it) {
+        os << (it == counters.begin() ? "" : ", ");
+        print_json_string(os, it->first);
+        os << ": " << it->second;
+    }
+    os << "}}";
+}
+
+}  // namespace support
@@ -0,0 +1,130 @@
+#include "../../include/support/trace.hpp"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace support::trace {
+
+namespace {
+
+struct Event {
+    std::string name;
+    std::string detail;
+    double start_us;
+    double duration_us;
+    int tid;
+};
+
+std::atomic<bool> enabled = false;
+std::mutex events_mutex;
+std::vector<Event> events;
+std::atomic<int> next_tid = 1;
+thread_local int current_tid = 0;
+
+[[nodiscard]] auto thread_id() -> int {
+    if (current_tid == 0) {
+        current_tid = next_tid++;
+    }
+    return current_tid;
+}
+
+[[nodiscard]] auto now_us() -> double {
+    const auto since_epoch = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration<double, std::micro>(since_epoch).count();
+}
+
+void write_json_string(std::ostream& os, std::string_view s) {
+    os << '"';
+    for (const char c : s) {
+        if (c == '"' || c == '\\') {
+            os << '\\';
+        }
+        if (static_cast<unsigned char>(c) >= 0x20) {
+            os << c;
+        }
+    }
+    os << '"';
+}
+
+}  // namespace
+
+void enable() { enabled = true; }
+
+auto is_enabled() -> bool { return enabled.load(std::memory_order_relaxed); }
+
+void write(const std::string& path) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        throw std::runtime_error("could not open trace file " + path);
+    }
+    const auto pid = getpid();
+    std::lock_guard lock(events_mutex);
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    for (std::size_t i = 0; i < events.size(); i++) {
+        const auto& event = events[i];
+        out << (i == 0 ? "" : ",\n") << "{\"name\": ";
+        write_json_string(out, event.name);
+        out << ", \"cat\": \"qac\", \"ph\": \"X\", \"ts\": " << std::fixed << event.start_us
+            << ", \"dur\": " << event.duration_us << ", \"pid\": " << pid
+            << ", \"tid\": " << event.tid;
+        if (!event.detail.empty()) {
+            out << ", \"args\": {\"detail\": ";
+            write_json_string(out, event.detail);
+            out << "}";
+        }
+        out << "}";
+    }
+    out << "\n]}\n";
+}
+
+Span::Span(std::string_view p_name, std::string_view p_detail) {
+    if (is_enabled()) {
+        active = true;
+        name = p_name;
+        detail = p_detail;
+        start_us = now_us();
+    }
+}
+
+Span::Span(Span&& other) noexcept
+    : active(std::exchange(other.active, false)),
+      start_us(other.start_us),
+      name(std::move(other.name)),
+      detail(std::move(other.detail)) {}
+
+auto Span::operator=(Span&& other) noexcept -> Span& {
+    if (this != &other) {
+        end();
+        active = std::exchange(other.active, false);
+        start_us = other.start_us;
+        name = std::move(other.name);
+        detail = std::move(other.detail);
+    }
+    return *this;
+}
+
+Span::~Span() { end(); }
+
+void Span::end() {
+    if (!active) {
+        return;
+    }
+    active = false;
+    const auto end_us = now_us();
+    const auto tid = thread_id();
+    std::lock_guard lock(events_mutex);
+    events.push_back(Event{.name = std::move(name),
+                           .detail = std::move(detail),
+                           .start_us = start_us,
+                           .duration_us = end_us - start_us,
+                           .tid = tid});
+}
+
+}  // namespace support::trace
@@ -1,11 +1,25 @@
 #include <gtest/gtest.h>
 
+#include <cctype>
+#include <chrono>
 #include <cstdlib>
 #include <expected>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <regex>
+#include <sstream>
 #include <string>
 #include <system_error>
+#include <thread>
+#include <vector>
+
+#include "include/compiler/ast_builder.hpp"
+#include "include/lexer/lexer.hpp"
+#include "include/lexer/scan.hpp"
+#include "include/parser/parser.hpp"
+#include "include/qac.hpp"
+#include "include/support/thread_pool.hpp"
 
 constexpr std::string compiler_path = "./build/bin/qac";
 constexpr std::string temp_dir = "./tmp/";
@@ -239,6 +253,612 @@ RUN_TEST_CASE(FloatGtVarValPos, "float_gt_var_val_pos.c");
 // array of floats
 RUN_TEST_CASE(FloatArr, "float_arr.c");
 
+[[nodiscard]] auto read_text(const std::string& path) -> std::string {
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+/** Driver */
+TEST(CompilerDriverTest, ParallelMultiFileMatchesSerial) {
+    const std::vector<std::string> names = {"max.c", "float_arr.c", "pass_arr3.c",
+                                            "complicated_if.c"};
+    std::string command = compiler_path.data() + std::string(" -j 4 -o ") + temp_dir + "multi/";
+    for (const auto& name : names) {
+        command += " " + std::string(test_dir) + "/" + name;
+    }
+    ASSERT_EQ(system(command.c_str()), 0);
+
+    for (const auto& name : names) {
+        ASSERT_TRUE(invoke_qac(std::string(test_dir) + "/" + name));
+        const auto stem = name.substr(0, name.size() - 2);
+        EXPECT_EQ(read_text(temp_dir + "multi/" + stem + ".asm"),
+                  read_text(compiler_gen_asm_path))
+            << name;
+    }
+}
+
+TEST(CompilerDriverTest, ParallelBackendMatchesSerial) {
+    const auto source = std::string(test_dir) + "/pass_vars_on_stack_more_involved.c";
+    const auto parallel_asm_path = temp_dir + "parallel.asm";
+    const auto command =
+        compiler_path.data() + std::string(" -j 4 ") + source + " -o " + parallel_asm_path;
+    ASSERT_EQ(system(command.c_str()), 0);
+    ASSERT_TRUE(invoke_qac(source));
+    EXPECT_EQ(read_text(parallel_asm_path), read_text(compiler_gen_asm_path));
+}
+
+TEST(CompilerDriverTest, ServerMatchesDriver) {
+    const auto socket_path = temp_dir + "qac.sock";
+    const auto server_command =
+        compiler_path.data() + std::string(" --server ") + socket_path + " & echo $! > " +
+        temp_dir + "server.pid";
+    std::filesystem::remove(socket_path);
+    ASSERT_EQ(system(server_command.c_str()), 0);
+    for (int i = 0; i < 100 && !std::filesystem::exists(socket_path); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    const auto source = std::string(test_dir) + "/float_arr.c";
+    const auto remote_asm_path = temp_dir + "remote.asm";
+    // front end options are forwarded, -j is the server's
+    const auto client_command = compiler_path.data() + std::string(" --connect=") + socket_path +
+                                " -j 64 --fused-front-end " + source + " -o " + remote_asm_path;
+    const auto client_result = system(client_command.c_str());
+    const auto kill_command = "kill $(cat " + temp_dir + "server.pid)";
+    ASSERT_EQ(system(kill_command.c_str()), 0);
+
+    ASSERT_EQ(client_result, 0);
+    ASSERT_TRUE(invoke_qac(source));
+    EXPECT_EQ(read_text(remote_asm_path), read_text(compiler_gen_asm_path));
+}
+
+TEST(CompilerDriverTest, CacheHitReusesAssembly) {
+    const auto cache_dir = temp_dir + "cache";
+    std::filesystem::remove_all(cache_dir);
+    const auto source = std::string(test_dir) + "/pass_arr3.c";
+    const auto cached_asm_path = temp_dir + "cached.asm";
+    const auto report_path = temp_dir + "cache_report.json";
+    const auto command = compiler_path.data() + std::string(" --cache-dir=") + cache_dir +
+                         " --time-report-json=" + report_path + " " + source + " -o " +
+                         cached_asm_path;
+
+    ASSERT_EQ(system(command.c_str()), 0);
+    EXPECT_NE(read_text(report_path).find("\"cache misses\": 1"), std::string::npos);
+    ASSERT_EQ(system(command.c_str()), 0);
+    EXPECT_NE(read_text(report_path).find("\"cache hits\": 1"), std::string::npos);
+
+    ASSERT_TRUE(invoke_qac(source));
+    EXPECT_EQ(read_text(cached_asm_path), read_text(compiler_gen_asm_path));
+}
+
+TEST(CompilerDriverTest, FunctionCacheRecompilesOnlyChangedFunctions) {
+    const auto cache_dir = temp_dir + "function_cache";
+    std::filesystem::remove_all(cache_dir);
+    const auto original = read_text(std::string(test_dir) + "/max.c");
+    const auto edited_source = temp_dir + "max_edited.c";
+    const auto report_path = temp_dir + "function_cache_report.json";
+    const auto command = compiler_path.data() + std::string(" --cache-dir=") + cache_dir +
+                         " --time-report-json=" + report_path + " " + edited_source + " -o " +
+                         temp_dir + "max_edited.asm";
+
+    std::ofstream(edited_source) << original;
+    ASSERT_EQ(system(command.c_str()), 0);
+    // the source changed, so the whole file cache misses, but max() and main() are unchanged
+    std::ofstream(edited_source) << original << "\nint unused() { return 1; }\n";
+    ASSERT_EQ(system(command.c_str()), 0);
+    EXPECT_NE(read_text(report_path).find("\"function cache hits\": 2"), std::string::npos)
+        << read_text(report_path);
+}
+
+TEST(CompilerDriverTest, DamagedFunctionCacheEntryIsAMiss) {
+    const auto cache_dir = temp_dir + "damaged_cache";
+    std::filesystem::remove_all(cache_dir);
+    const auto source = std::string(test_dir) + "/max.c";
+    const auto cached_asm_path = temp_dir + "damaged_cache.asm";
+    const auto command = compiler_path.data() + std::string(" --cache-dir=") + cache_dir + " " +
+                         source + " -o " + cached_asm_path;
+    ASSERT_EQ(system(command.c_str()), 0);
+
+    // function entries start with the length of their data section, the whole file entry is
+    // dropped so that the functions are looked up again
+    std::size_t damaged = 0;
+    for (const auto& file : std::filesystem::directory_iterator(cache_dir)) {
+        const auto entry = read_text(file.path().string());
+        if (entry.empty() || !std::isdigit(static_cast<unsigned char>(entry.front()))) {
+            std::filesystem::remove(file.path());
+        } else if (damaged++ == 0) {
+            std::ofstream(file.path()) << "garbage\n";
+        }
+    }
+    ASSERT_GT(damaged, 0u);
+
+    ASSERT_EQ(system(command.c_str()), 0);
+    ASSERT_TRUE(invoke_qac(source));
+    EXPECT_EQ(read_text(cached_asm_path), read_text(compiler_gen_asm_path));
+}
+
+TEST(CompilerDriverTest, UnusableCacheDirIsSkipped) {
+    // the cache directory would have to be created below a regular file
+    const auto blocker = temp_dir + "cache_blocker";
+    std::filesystem::remove_all(blocker);
+    std::ofstream(blocker) << "";
+    const auto source = std::string(test_dir) + "/pass_arr3.c";
+    const auto cached_asm_path = temp_dir + "uncached.asm";
+    const auto report_path = temp_dir + "unusable_cache_report.json";
+    const auto command = compiler_path.data() + std::string(" --cache-dir=") + blocker +
+                         "/cache --time-report-json=" + report_path + " " + source + " -o " +
+                         cached_asm_path;
+
+    ASSERT_EQ(system(command.c_str()), 0);
+    EXPECT_NE(read_text(report_path).find("\"cache store failures\": 1"), std::string::npos)
+        << read_text(report_path);
+    ASSERT_TRUE(invoke_qac(source));
+    EXPECT_EQ(read_text(cached_asm_path), read_text(compiler_gen_asm_path));
+}
+
+TEST(CompilerDriverTest, StdinInputMatchesFileInput) {
+    const auto source = std::string(test_dir) + "/for_loop_arr.c";
+    const auto stdin_asm_path = temp_dir + "stdin.asm";
+    const auto command =
+        compiler_path.data() + std::string(" - -o ") + stdin_asm_path + " < " + source;
+    ASSERT_EQ(system(command.c_str()), 0);
+    ASSERT_TRUE(invoke_qac(source));
+    EXPECT_EQ(read_text(stdin_asm_path), read_text(compiler_gen_asm_path));
+}
+
+TEST(CompilerDriverTest, DumpWritesOneFilePerStage) {
+    const auto source = std::string(test_dir) + "/max.c";
+    const auto asm_path = temp_dir + "dumped.asm";
+    const std::vector<std::string> stages = {"st", "ast", "ir", "opt-ir", "target-ir"};
+    for (const auto& stage : stages) {
+        std::filesystem::remove(asm_path + "." + stage);
+    }
+    const auto command = compiler_path.data() +
+                         std::string(" --dump=st,ast,ir,opt-ir,target-ir ") + source + " -o " +
+                         asm_path;
+    ASSERT_EQ(system(command.c_str()), 0);
+    for (const auto& stage : stages) {
+        EXPECT_FALSE(read_text(asm_path + "." + stage).empty()) << stage;
+    }
+}
+
+TEST(CompilerDriverTest, DefaultCompileDumpsNothing) {
+    const auto source = std::string(test_dir) + "/max.c";
+    const auto asm_path = temp_dir + "undumped.asm";
+    const auto stdout_path = temp_dir + "undumped.stdout";
+    const std::vector<std::string> stages = {"st", "ast", "ir", "opt-ir", "target-ir"};
+    for (const auto& stage : stages) {
+        std::filesystem::remove(asm_path + "." + stage);
+    }
+    const auto command =
+        compiler_path.data() + std::string(" ") + source + " -o " + asm_path + " > " + stdout_path;
+    ASSERT_EQ(system(command.c_str()), 0);
+    for (const auto& stage : stages) {
+        EXPECT_FALSE(std::filesystem::exists(asm_path + "." + stage)) << stage;
+    }
+    EXPECT_EQ(read_text(stdout_path), "");
+}
+
+TEST(CompilerDriverTest, DumpRejectsUnknownStage) {
+    const auto source = std::string(test_dir) + "/max.c";
+    const auto command = compiler_path.data() + std::string(" --dump=ast,tokens ") + source +
+                         " -o " + temp_dir + "unknown_stage.asm 2> /dev/null";
+    EXPECT_NE(system(command.c_str()), 0);
+}
+
+TEST(CompilerDriverTest, TimeReportJsonHasEveryPhase) {
+    const auto source = std::string(test_dir) + "/max.c";
+    const auto report_path = temp_dir + "phases_report.json";
+    std::filesystem::remove(report_path);
+    const auto command = compiler_path.data() + std::string(" -j 1 --time-report-json=") +
+                         report_path + " " + source + " -o " + temp_dir + "phases.asm";
+    ASSERT_EQ(system(command.c_str()), 0);
+
+    const auto report = read_text(report_path);
+    for (const std::string phase :
+         {"read", "parse", "translate", "ir", "opt", "lower", "regalloc", "codegen", "write"}) {
+        const std::regex fields("\\{\"name\": \"" + phase +
+                                "\", \"wall_ms\": ([^,]+), \"cpu_ms\": ([^,]+), [^}]*"
+                                "\"objects\": ([0-9]+)");
+        std::smatch match;
+        ASSERT_TRUE(std::regex_search(report, match, fields)) << phase << "\n" << report;
+        EXPECT_GE(std::stod(match[1]), 0) << phase;
+        EXPECT_GE(std::stod(match[2]), 0) << phase;
+        EXPECT_GT(std::stoul(match[3]), 0u) << phase;
+    }
+}
+
+TEST(CompilerDriverTest, UnwritableTimeReportJsonFails) {
+    const auto source = std::string(test_dir) + "/max.c";
+    const auto command = compiler_path.data() + std::string(" --time-report-json=") + temp_dir +
+                         "missing_dir/report.json " + source + " -o " + temp_dir +
+                         "unreported.asm 2> /dev/null";
+    EXPECT_NE(system(command.c_str()), 0);
+}
+
+TEST(CompilerDriverTest, TraceHasPhaseAndFunctionSpans) {
+    // max.c defines max() and main()
+    const auto source = std::string(test_dir) + "/max.c";
+    const auto trace_path = temp_dir + "trace.json";
+    std::filesystem::remove(trace_path);
+    const auto command = compiler_path.data() + std::string(" -j 1 --trace=") + trace_path + " " +
+                         source + " -o " + temp_dir + "traced.asm";
+    ASSERT_EQ(system(command.c_str()), 0);
+
+    const auto trace = read_text(trace_path);
+    ASSERT_EQ(trace.rfind("{\"displayTimeUnit\": \"ms\", \"traceEvents\": [", 0), 0u) << trace;
+    for (const std::string phase : {"read", "parse", "translate", "ir", "opt", "lower", "regalloc",
+                                    "codegen", "write"}) {
+        EXPECT_NE(trace.find("{\"name\": \"" + phase + "\", \"cat\": \"qac\", \"ph\": \"X\""),
+                  std::string::npos)
+            << phase;
+    }
+    for (const std::string event : {"Produce_IR", "LowerIR", "rewrite", "Generate"}) {
+        for (const std::string function : {"max", "main"}) {
+            const std::regex span("\\{\"name\": \"" + event +
+                                  "\", [^}]*\"args\": \\{\"detail\": \"" + function + "\"\\}\\}");
+            EXPECT_TRUE(std::regex_search(trace, span)) << event << " " << function;
+        }
+    }
+}
+
+TEST(CompilerDriverTest, UnwritableTraceFails) {
+    const auto source = std::string(test_dir) + "/max.c";
+    const auto command = compiler_path.data() + std::string(" --trace=") + temp_dir +
+                         "missing_dir/trace.json " + source + " -o " + temp_dir +
+                         "untraced.asm 2> /dev/null";
+    EXPECT_NE(system(command.c_str()), 0);
+}
+
+TEST(CompilerDriverTest, FirstErrorDoesNotDependOnJobs) {
+    // big enough to be lexed in parallel, with a syntax error before a lexer error
+    const auto source = temp_dir + "syntax_then_lexer_error.c";
+    {
+        std::ofstream file(source);
+        file << "int broken() { return 1 1; }\n";
+        for (int i = 0; i < 20000; i++) {
+            file << "int f" << i << "(int a) { return a + " << i << "; }\n";
+        }
+        file << "int late() { return `; }\n";
+    }
+    std::string diagnostics[2];
+    const std::string jobs[2] = {"1", "4"};
+    for (int i = 0; i < 2; i++) {
+        const auto stderr_path = temp_dir + "first_error_j" + jobs[i] + ".txt";
+        const auto command = compiler_path.data() + std::string(" -j ") + jobs[i] + " " + source +
+                             " -o " + temp_dir + "first_error.asm 2> " + stderr_path;
+        EXPECT_NE(system(command.c_str()), 0);
+        diagnostics[i] = read_text(stderr_path);
+    }
+    EXPECT_FALSE(diagnostics[0].empty());
+    EXPECT_EQ(diagnostics[0], diagnostics[1]);
+}
+
+/** Lexer */
+[[nodiscard]] auto same_token(const Token& a, const Token& b) -> bool {
+    return a.type == b.type && a.offset == b.offset && a.length == b.length && a.line == b.line &&
+           a.column == b.column;
+}
+
+TEST(LexerScanTest, VectorScannersMatchScalar) {
+    // every kind of run, ending at every offset across and past a 32 byte block, followed by
+    // bytes that must stop it, including one with the high bit set
+    const std::string runs[] = {" \t\r", "abcXYZ_09", "0123456789", "// comment \t"};
+    const std::string stops[] = {"\n", "(", "\x80", "`", "{", "@", "[", "/", ":", ""};
+    const auto scanners = lexer::available_scanners();
+    ASSERT_EQ(scanners.front().name, "scalar");
+    for (const auto& run : runs) {
+        for (std::size_t length = 0; length < 80; length++) {
+            for (const auto& stop : stops) {
+                std::string text;
+                while (text.size() < length) {
+                    text += run[text.size() % run.size()];
+                }
+                text += stop;
+                const char* begin = text.data();
+                const char* end = begin + text.size();
+                const auto& scalar = scanners.front();
+                for (const auto& scanner : scanners) {
+                    SCOPED_TRACE(std::string(scanner.name) + " on \"" + text + "\"");
+                    EXPECT_EQ(scanner.skip_blanks(begin, end), scalar.skip_blanks(begin, end));
+                    EXPECT_EQ(scanner.find_newline(begin, end), scalar.find_newline(begin, end));
+                    EXPECT_EQ(scanner.identifier_end(begin, end),
+                              scalar.identifier_end(begin, end));
+                    EXPECT_EQ(scanner.digits_end(begin, end), scalar.digits_end(begin, end));
+                }
+            }
+        }
+    }
+}
+
+TEST(LexerTest, LexersKeepIndependentState) {
+    const auto first = read_text(std::string(test_dir) + "/float_arr.c");
+    const auto second = read_text(std::string(test_dir) + "/for_loop_arr.c");
+    const auto expected_first = lexer::lex(first);
+    const auto expected_second = lexer::lex(second);
+
+    // two lexers pulled in turn on one thread must not disturb each other
+    lexer::Lexer a(first);
+    lexer::Lexer b(second);
+    for (std::size_t i = 0; i < std::max(expected_first.size(), expected_second.size()); i++) {
+        if (i < expected_first.size()) {
+            EXPECT_TRUE(same_token(a.next(), expected_first[i])) << "token " << i;
+        }
+        if (i < expected_second.size()) {
+            EXPECT_TRUE(same_token(b.next(), expected_second[i])) << "token " << i;
+        }
+    }
+    EXPECT_EQ(a.next().type, TokType::TOKEN_FEOF);
+}
+
+TEST(LexerTest, ParallelLexMatchesSerial) {
+    const auto function = read_text(std::string(test_dir) + "/float_arr.c");
+    std::string source;
+    while (source.size() < 5 * lexer::parallel_lex_min_chunk) {
+        source += "// a comment line\r\n\t  " + function;
+    }
+    support::ThreadPool pool(4);
+    const auto expected = lexer::lex(source);
+    const auto tokens = lexer::lex_parallel(source, pool);
+    ASSERT_EQ(tokens.size(), expected.size());
+    for (std::size_t i = 0; i < tokens.size(); i++) {
+        ASSERT_TRUE(same_token(tokens[i], expected[i])) << "token " << i;
+    }
+
+    // the error serial lexing reports, even though the failing chunk does not know its line
+    source += "int late() { return 1 $ 2; }\n";
+    std::string serial_error = "";
+    std::string parallel_error = "";
+    try {
+        static_cast<void>(lexer::lex(source));
+    } catch (const std::runtime_error& e) {
+        serial_error = e.what();
+    }
+    try {
+        static_cast<void>(lexer::lex_parallel(source, pool));
+    } catch (const std::runtime_error& e) {
+        parallel_error = e.what();
+    }
+    EXPECT_FALSE(serial_error.empty());
+    EXPECT_EQ(parallel_error, serial_error);
+}
+
+TEST(LexerTest, NumbersAreConvertedOnce) {
+    const auto tokens = lexer::lex("2147483647 3.25 0 1.");
+    ASSERT_EQ(tokens.size(), 6u);
+    EXPECT_EQ(tokens[0].type, TokType::TOKEN_NUMBER);
+    EXPECT_EQ(tokens[0].int_value, 2147483647);
+    EXPECT_EQ(tokens[1].type, TokType::TOKEN_FLOAT_NUMBER);
+    EXPECT_EQ(tokens[1].float_value, 3.25f);
+    EXPECT_EQ(tokens[2].int_value, 0);
+    // no digit after the dot, so an integer and a dot
+    EXPECT_EQ(tokens[3].type, TokType::TOKEN_NUMBER);
+    EXPECT_EQ(tokens[4].type, TokType::TOKEN_DOT);
+
+    const auto result = qac::compile("int main() { return 2147483648; }");
+    EXPECT_FALSE(result.ok);
+    EXPECT_NE(result.diagnostics.find("2147483648 is out of range on line 1"), std::string::npos)
+        << result.diagnostics;
+}
+
+/** Parser */
+TEST(ParserTest, StreamingKeepsTokenBufferBounded) {
+    const auto function = read_text(std::string(test_dir) + "/for_loop_arr.c");
+    std::string source;
+    for (int i = 0; i < 200; i++) {
+        // for_loop_arr.c defines main(); the parser does not mind the repeats
+        source += function;
+    }
+    const auto tokens = lexer::lex(source);
+    const auto expected = st::count_nodes(parse(tokens, source));
+
+    Parser parser(source);
+    EXPECT_EQ(st::count_nodes(parser.parseProgram()), expected);
+    EXPECT_EQ(parser.tokens().position() + 1, tokens.size());
+    EXPECT_LT(parser.tokens().buffered_peak(), 128u) << "of " << tokens.size() << " tokens";
+}
+
+TEST(ParserTest, ParsersRunConcurrently) {
+    const std::string names[] = {"float_arr.c", "for_loop_arr.c", "int_arr.c", "IfElse.c"};
+    std::vector<std::string> sources;
+    std::vector<std::size_t> expected;
+    for (const auto& name : names) {
+        sources.push_back(read_text(std::string(test_dir) + "/" + name));
+        expected.push_back(st::count_nodes(Parser(sources.back()).parseProgram()));
+    }
+    std::vector<std::size_t> counts(sources.size(), 0);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < sources.size(); i++) {
+        threads.emplace_back([&, i] {
+            // many rounds, so the parsers really overlap
+            for (int round = 0; round < 200; round++) {
+                counts[i] = st::count_nodes(Parser(sources[i]).parseProgram());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(counts, expected);
+}
+
+TEST(ParserTest, NestedCallsParseWithBoundedLookahead) {
+    // x = f(f(...f(1)...)); nests `depth` calls, each argument an assignment expression
+    const auto statement = [](int depth) {
+        std::string source = "int main() { x = ";
+        for (int i = 0; i < depth; i++) {
+            source += "f(";
+        }
+        source += "1";
+        source += std::string(static_cast<std::size_t>(depth), ')');
+        return source + "; }";
+    };
+    // the streaming parser only holds the tokens it looks ahead at, so a parser that scans ahead
+    // for the `=` at every argument, quadratic in the nesting, holds most of the statement
+    const auto lookahead = [](const std::string& source) {
+        Parser parser(source);
+        const auto program = parser.parseProgram();
+        return parser.tokens().buffered_peak();
+    };
+    const auto small = lookahead(statement(500));
+    const auto large = lookahead(statement(2000));
+    EXPECT_EQ(small, large);
+    EXPECT_LT(large, 16u) << "tokens held for 2000 nested calls";
+}
+
+TEST(ParserTest, BinaryOperatorsFollowPrecedenceAndAssociativity) {
+    const auto same_code = [](const std::string& expr, const std::string& grouped) {
+        const auto a = qac::compile("int main() { int a = 7; int b = 3; return " + expr + "; }");
+        const auto b = qac::compile("int main() { int a = 7; int b = 3; return " + grouped + "; }");
+        EXPECT_TRUE(a.ok) << expr << ": " << a.diagnostics;
+        EXPECT_EQ(a.assembly, b.assembly) << expr << " vs " << grouped;
+    };
+    same_code("a - b - 1", "(a - b) - 1");
+    same_code("a + b * 2 - a / b", "(a + (b * 2)) - (a / b)");
+    same_code("a + b > b * 2", "(a + b) > (b * 2)");
+    same_code("a < b == b > a", "(a < b) == (b > a)");
+    same_code("-a * b", "(-a) * b");
+
+    // comparisons and assignments do not chain
+    EXPECT_FALSE(qac::compile("int main() { int a = 1; return a < 2 < 3; }").ok);
+    EXPECT_FALSE(qac::compile("int main() { int a = 1; int b = 2; a = b = 3; return a; }").ok);
+}
+
+TEST(ParserTest, NestedListsKeepTheirOwnNodes) {
+    const std::string source = "int main() { if (a) { b = f(g(1, 2), h(3)); } return 4; }";
+    const auto program = Parser(source).parseProgram();
+    const auto& tree = program.tree;
+    ASSERT_EQ(program.nodes.size(), 1u);
+    const auto body = tree.list(std::get<st::FuncDef>(program.nodes[0].node).body.items);
+    ASSERT_EQ(body.size(), 2u);
+
+    const auto& if_stmt = tree.get<st::SelectionStatement>(std::get<st::Statement>(body[0].item));
+    const auto then = tree.list(if_stmt.then.items);
+    ASSERT_EQ(then.size(), 1u);
+    const auto& assign = tree.get<st::AssignmentExpression>(
+        tree.get<st::ExpressionStatement>(std::get<st::Statement>(then[0].item)).expr);
+    const auto& f = tree.get<st::FunctionCallExpression>(assign.rhs);
+    EXPECT_EQ(f.name, "f");
+    // names are views into the source rather than copies
+    EXPECT_GE(f.name.data(), source.data());
+    EXPECT_LT(f.name.data(), source.data() + source.size());
+
+    // g's and h's arguments were parsed while f's list was open
+    const auto args = tree.list(f.args);
+    ASSERT_EQ(args.size(), 2u);
+    const auto& g = tree.get<st::FunctionCallExpression>(args[0]);
+    const auto& h = tree.get<st::FunctionCallExpression>(args[1]);
+    EXPECT_EQ(g.name, "g");
+    EXPECT_EQ(h.name, "h");
+    std::vector<int> values;
+    for (const auto arg : tree.list(g.args)) {
+        values.push_back(tree.get<st::PrimaryExpression>(arg).value);
+    }
+    for (const auto arg : tree.list(h.args)) {
+        values.push_back(tree.get<st::PrimaryExpression>(arg).value);
+    }
+    EXPECT_EQ(values, (std::vector<int>{1, 2, 3}));
+
+    const auto& ret = tree.get<st::ReturnStatement>(std::get<st::Statement>(body[1].item));
+    EXPECT_EQ(tree.get<st::PrimaryExpression>(ret.expr).value, 4);
+}
+
+TEST(ParserTest, SinglePassMatchesTranslatedTree) {
+    // dereferences only become writes once the `=` after them is seen
+    const std::string source =
+        "int f(int *p, int x) { int a[4]; int *q = p; *p = *q + 1; a[*p] = a[x] - -(3); *q;"
+        " return *p; }"
+        "int g(int *p) { *p; int y = 2; *p; f(*p, y); for (int i = 0; i < 3; i = i + 1) {"
+        " *p = i; if (*p) { *p = -i; } else { y = *p; } } return -y; }";
+    const auto translated = ast::translate(Parser(source).parseProgram());
+    const auto fused = ast::AstParser(source).parseProgram();
+    ASSERT_EQ(fused.size(), translated.size());
+    EXPECT_EQ(ast::count_nodes(fused), ast::count_nodes(translated));
+    for (std::size_t i = 0; i < fused.size(); i++) {
+        EXPECT_EQ(ast::fingerprint(*fused[i].get_function()),
+                  ast::fingerprint(*translated[i].get_function()));
+    }
+
+    // left to the two pass front end
+    const std::string nested = "int main() { int a[2]; int b = 0; a[b = 1] = 2; return b; }";
+    EXPECT_THROW((void)ast::AstParser(nested).parseProgram(), ast::NotReproducible);
+    EXPECT_NO_THROW((void)ast::translate(Parser(nested).parseProgram()));
+}
+
+TEST(ParserTest, OutlinedDeclarationsMatchEagerParse) {
+    // g sees f's q and starts from the context f leaves, k sees the loop variable of h
+    const std::string source =
+        "int f(int *p) { int *q = p; *p = *q + 1; }"
+        "int g(int *p) { *p; return *q; }"
+        "int *r;"
+        "int h() { int a[2]; a[0] = *r; for (int i = 0; i < 2; i = i + 1) { a[i] = i; }"
+        " return a[1]; }"
+        ";int k() { return *r + i; }";
+    const auto tokens = lexer::lex(source);
+    const auto outline = Parser(tokens, source).outlineProgram();
+    ASSERT_EQ(outline.size(), 5u);
+
+    std::vector<st::Program> parts;
+    for (std::size_t i = 0; i < outline.size(); i++) {
+        parts.push_back(Parser(tokens, source).parseExternalDeclarations(
+            std::span(outline).subspan(i, 1)));
+    }
+    support::ThreadPool pool(4);
+    const auto in_parts = ast::translate_parts(parts, pool);
+    const auto eager = ast::translate(Parser(tokens, source).parseProgram());
+    ASSERT_EQ(in_parts.size(), eager.size());
+    EXPECT_EQ(ast::count_nodes(in_parts), ast::count_nodes(eager));
+    for (std::size_t i = 0; i < eager.size(); i++) {
+        ASSERT_EQ(in_parts[i].is_function(), eager[i].is_function());
+        if (eager[i].is_function()) {
+            EXPECT_EQ(ast::fingerprint(*in_parts[i].get_function()),
+                      ast::fingerprint(*eager[i].get_function()));
+        }
+    }
+
+    // braces the outline cannot match are left to parseProgram()
+    const std::string unbalanced = "int f() { { return 1; } int g() { return 2; }";
+    const auto unbalanced_tokens = lexer::lex(unbalanced);
+    const auto unbalanced_outline = Parser(unbalanced_tokens, unbalanced).outlineProgram();
+    EXPECT_THROW((void)Parser(unbalanced_tokens, unbalanced)
+                     .parseExternalDeclarations(unbalanced_outline),
+                 std::runtime_error);
+    const std::string two = "int x; int y;";
+    const auto two_tokens = lexer::lex(two);
+    const TokenRange both[] = {{.begin = 0, .end = 6}};
+    EXPECT_THROW((void)Parser(two_tokens, two).parseExternalDeclarations(both), OutlineMismatch);
+}
+
+/** Library */
+TEST(CompilerLibraryTest, CompileInMemoryMatchesDriver) {
+    const auto source_path = std::string(test_dir) + "/float_arr.c";
+    const auto result = qac::compile(read_text(source_path));
+    ASSERT_TRUE(result.ok) << result.diagnostics;
+    ASSERT_TRUE(invoke_qac(source_path));
+    EXPECT_EQ(result.assembly, read_text(compiler_gen_asm_path));
+}
+
+TEST(CompilerLibraryTest, CompileInMemoryReportsErrors) {
+    const auto result = qac::compile("int main() { return 1 $ 2; }", {.source_name = "bad.c"});
+    EXPECT_FALSE(result.ok);
+    EXPECT_TRUE(result.assembly.empty());
+    EXPECT_TRUE(result.diagnostics.starts_with("bad.c: error: ")) << result.diagnostics;
+}
+
+TEST(CompilerLibraryTest, KeywordLikeIdentifiersAreIdentifiers) {
+    // identifiers sharing a length, prefix or last letter with a keyword
+    const auto keyword_like = qac::compile(
+        "int main() { int iffy = 1; int fort = 2; int doubles = 3; int in = 4;"
+        " return iffy + fort + doubles + in; }");
+    const auto plain = qac::compile(
+        "int main() { int a = 1; int b = 2; int c = 3; int d = 4; return a + b + c + d; }");
+    ASSERT_TRUE(keyword_like.ok) << keyword_like.diagnostics;
+    ASSERT_TRUE(plain.ok) << plain.diagnostics;
+    EXPECT_EQ(keyword_like.assembly, plain.assembly);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();